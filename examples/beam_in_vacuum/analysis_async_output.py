@@ -0,0 +1,66 @@
+#! /usr/bin/env python3
+
+# Copyright 2024
+#
+# This file is part of HiPACE++.
+#
+# License: BSD-3-Clause-LBNL
+
+
+# This script compares the beam output of a simulation written synchronously with the output of
+# the same simulation written asynchronously (hipace.openpmd_async_write) and asserts that
+# they contain the same particles. The test setup has to lose particles.
+# With --chunked, the output was written with hipace.openpmd_beam_chunk_size, where particles lost
+# during a time step are written as zero-weight padding that is removed before the comparison.
+
+import numpy as np
+import argparse
+from openpmd_viewer import OpenPMDTimeSeries
+
+parser = argparse.ArgumentParser(
+    description='Script to compare synchronous and asynchronous beam output')
+parser.add_argument('--reference',
+                    dest='reference',
+                    required=True,
+                    help='Path to the directory containing the synchronous output')
+parser.add_argument('--async',
+                    dest='async_output',
+                    required=True,
+                    help='Path to the directory containing the asynchronous output')
+parser.add_argument('--chunked',
+                    dest='chunked',
+                    action='store_true',
+                    default=False,
+                    help='Whether the asynchronous output was written in chunks')
+args = parser.parse_args()
+
+ts_ref = OpenPMDTimeSeries(args.reference)
+ts_async = OpenPMDTimeSeries(args.async_output)
+
+assert np.array_equal(ts_ref.iterations, ts_async.iterations)
+
+var_list = ['id', 'x', 'y', 'z', 'ux', 'uy', 'uz', 'w']
+num_particles = []
+num_padded = 0
+for iteration in ts_ref.iterations:
+    ref = ts_ref.get_particle(species='beam', iteration=iteration, var_list=var_list)
+    out = ts_async.get_particle(species='beam', iteration=iteration, var_list=var_list)
+
+    if args.chunked:
+        # remove the zero-weight padding of particles lost during the time step
+        valid = out[-1] != 0.
+        num_padded += np.sum(~valid)
+        out = [v[valid] for v in out]
+
+    print('iteration', iteration, ': particles', len(ref[0]))
+    assert len(ref[0]) == len(out[0])
+    num_particles.append(len(ref[0]))
+
+    order_ref = np.argsort(ref[0])
+    order_out = np.argsort(out[0])
+    for name, v_ref, v_out in zip(var_list, ref, out):
+        assert np.array_equal(v_ref[order_ref], v_out[order_out]), name + ' differs'
+
+assert num_particles[-1] < num_particles[0]
+if args.chunked:
+    assert num_padded > 0
@@ -15,6 +15,7 @@
 #include "utils/DeprecatedInput.H"
 #include "utils/IOUtil.H"
 #include "utils/GPUUtil.H"
+#include "utils/ScratchArena.H"
 #include "particles/pusher/GetAndSetPosition.H"
 #include "mg_solver/HpMultiGrid.H"
 #include "fields/fft_poisson_solver/fft/AnyFFT.H"
@@ -45,6 +46,8 @@ Hipace_early_init::Hipace_early_init (Hipace* instance)
     }
     Parser::replaceAmrexParamsWithParser();
 
+    HipaceTracer::Initialize();
+
     queryWithParser(pph, "do_device_synchronize", DO_DEVICE_SYNCHRONIZE);
     queryWithParser(pph, "depos_order_xy", m_depos_order_xy);
     queryWithParser(pph, "depos_order_z", m_depos_order_z);
@@ -110,6 +113,10 @@ Hipace::Hipace () :
     queryWithParser(pph, "predcorr_B_error_tolerance", m_predcorr_B_error_tolerance);
     queryWithParser(pph, "predcorr_max_iterations", m_predcorr_max_iterations);
     queryWithParser(pph, "predcorr_B_mixing_factor", m_predcorr_B_mixing_factor);
+    queryWithParser(pph, "predcorr_anderson_depth", m_predcorr_anderson_depth);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_predcorr_anderson_depth >= 0 && m_predcorr_anderson_depth <= 8,
+        "hipace.predcorr_anderson_depth must be between 0 and 8");
     queryWithParser(pph, "do_beam_jx_jy_deposition", m_do_beam_jx_jy_deposition);
     queryWithParser(pph, "do_beam_jz_minus_rho", m_do_beam_jz_minus_rho);
     m_deposit_rho = m_diags.needsRho();
@@ -154,10 +161,17 @@ Hipace::Hipace () :
     queryWithParser(pph, "MG_tolerance_rel", m_MG_tolerance_rel);
     queryWithParser(pph, "MG_tolerance_abs", m_MG_tolerance_abs);
     queryWithParser(pph, "MG_verbose", m_MG_verbose);
+    queryWithParser(pph, "MG_use_bicgstab", m_MG_use_bicgstab);
+    queryWithParser(pph, "MG_use_mixed_precision", m_MG_use_mixed_precision);
+    queryWithParser(pph, "MG_initial_guess_order", m_MG_initial_guess_order);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_MG_initial_guess_order >= 0 && m_MG_initial_guess_order <= 2,
+        "hipace.MG_initial_guess_order must be 0, 1 or 2");
     queryWithParser(pph, "use_amrex_mlmg", m_use_amrex_mlmg);
     queryWithParser(pph, "do_shared_depos", m_do_shared_depos);
+    queryWithParser(pph, "fuse_plasma_push_deposit", m_fuse_plasma_push_deposit);
     queryWithParser(pph, "do_tiling", m_do_tiling);
     queryWithParser(pph, "tile_size", m_tile_size);
+    queryWithParser(pph, "do_private_tile_depos", m_do_private_tile_depos);
 #ifdef AMREX_USE_GPU
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_do_tiling==0, "Tiling must be turned off to run on GPU.");
 #endif
@@ -236,6 +250,15 @@ Hipace::Hipace () :
      for (int i = 0; i < m_ncollisions; ++i) {
          m_all_collisions.emplace_back(CoulombCollision(m_multi_plasma.m_names, m_multi_beam.m_names, m_collision_names[i]));
      }
+    if (m_fuse_plasma_push_deposit) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_explicit && m_N_level == 1,
+            "hipace.fuse_plasma_push_deposit requires the explicit solver and no mesh refinement");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_deposit_rho_individual,
+            "hipace.fuse_plasma_push_deposit cannot be used with hipace.deposit_rho_individual");
+        // collisions modify the plasma momenta after the push
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_ncollisions == 0,
+            "hipace.fuse_plasma_push_deposit cannot be used with collisions");
+    }
      if (m_normalized_units && m_ncollisions > 0) {
          AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_background_density_SI!=0,
              "For collisions with normalized units, a background plasma density must "
@@ -400,6 +423,8 @@ Hipace::Evolve ()
     // now each rank starts with its own time step and writes to its own file. The first rank starts with step 0
     for (int step = rank; step <= m_max_step; step += m_numprocs)
     {
+        HipaceTracer::SetSliceStep(-1, step);
+
         ResetAllQuantities();
 
         const amrex::Box& bx = m_3D_ba[0][0];
@@ -488,8 +513,18 @@ Hipace::Evolve ()
         m_multi_beam.InSituWriteToFile(step, m_physical_time, m_3D_geom[0], m_max_step, m_max_time);
         m_multi_plasma.InSituWriteToFile(step, m_physical_time, m_3D_geom[0], m_max_step, m_max_time);
         m_multi_laser.InSituWriteToFile(step, m_physical_time, m_max_step, m_max_time);
+        m_insitu_writer.EndStep();
+        m_multi_beam.ReportSubcyclingStats(step, m_verbose >= 2);
 
-        if (!m_explicit) {
+        if (m_explicit) {
+            m_MG_avg_iterations /= bx.length(Direction::z);
+            if (m_verbose >= 2) {
+                amrex::AllPrint() << "Rank " << rank
+                                  << ": avg. number of hpmg iterations " << m_MG_avg_iterations
+                                  << "\n";
+            }
+            m_MG_avg_iterations = 0.;
+        } else {
             // averaging predictor corrector loop diagnostics
             m_predcorr_avg_iterations /= bx.length(Direction::z);
             m_predcorr_avg_B_error /= bx.length(Direction::z);
@@ -506,6 +541,10 @@ Hipace::Evolve ()
         FlushDiagnostics();
     }
 
+#ifdef HIPACE_USE_OPENPMD
+    m_openpmd_writer.WaitForAsyncFlush();
+#endif
+
     if (m_verbose >= 1) {
         // print total time, time per particle push and time per cell update
         amrex::ParallelDescriptor::ReduceRealSum(amrex::Vector<std::reference_wrapper<double>>{
@@ -549,6 +588,10 @@ Hipace::Evolve ()
                 }
                 std::cout << std::endl;
             }
+
+            std::cout << "Peak scratch memory per slice: "
+                      << The_Scratch_Arena()->PeakUsage() / (1024. * 1024.) << " MiB"
+                      << std::endl;
         }
     }
 }
@@ -564,8 +607,12 @@ Hipace::SolveOneSlice (int islice, int step)
         MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
     }
 #endif
+    HipaceTracer::SetSliceStep(islice, step);
     HIPACE_PROFILE("Hipace::SolveOneSlice()");
 
+    const double num_plasma_particles_pushed_start = m_num_plasma_particles_pushed;
+    const double num_beam_particles_pushed_start = m_num_beam_particles_pushed;
+
     int current_N_level = 1;
 
     for (int lev=1; lev<m_N_level; ++lev) {
@@ -592,7 +639,7 @@ Hipace::SolveOneSlice (int islice, int step)
     }
 
     // reorder plasma
-    m_multi_plasma.ReorderParticles(islice);
+    m_multi_plasma.ReorderParticles(islice, m_fields.getSlices(0).fabbox(0), m_3D_geom[0]);
 
     // prepare/initialize fields
     for (int lev=0; lev<current_N_level; ++lev) {
@@ -600,14 +647,20 @@ Hipace::SolveOneSlice (int islice, int step)
     }
 
     // write laser aabs into fields MultiFab
-    m_multi_laser.UpdateLaserAabs(islice, current_N_level, m_fields, m_3D_geom);
+    m_multi_laser.UpdateLaserAabs(islice, current_N_level, m_fields, m_3D_geom, WhichSlice::This);
+
+    // with the fused plasma push and deposition, only the first slice deposits the plasma here
+    const bool fused_plasma_deposit =
+        m_fuse_plasma_push_deposit && islice != m_3D_geom[0].Domain().bigEnd(Direction::z);
 
     // deposit current
     for (int lev=0; lev<current_N_level; ++lev) {
         if (m_explicit) {
             // deposit jx, jy, chi and rhomjz for all plasmas
-            m_multi_plasma.DepositCurrent(m_fields, WhichSlice::This, true, false,
-                m_deposit_rho || m_deposit_rho_individual, true, true, m_3D_geom, lev);
+            if (!fused_plasma_deposit) {
+                m_multi_plasma.DepositCurrent(m_fields, WhichSlice::This, true, false,
+                    m_deposit_rho || m_deposit_rho_individual, true, true, m_3D_geom, lev);
+            }
 
             // deposit jz_beam and maybe rhomjz of the beam on This slice
             m_multi_beam.DepositCurrentSlice(m_fields, m_3D_geom, lev, step,
@@ -662,6 +715,11 @@ Hipace::SolveOneSlice (int islice, int step)
             // Deposit Sx and Sy for every plasma species
             m_multi_plasma.ExplicitDeposition(m_fields, m_3D_geom, lev);
 
+            // Extrapolate the initial guess of Bx, By from the previous slices of this level,
+            // order n needs n+1 of them
+            m_fields.ExtrapolateBfieldGuess(std::min(m_MG_initial_guess_order,
+                std::max(0, m_3D_geom[lev].Domain().bigEnd(Direction::z) - islice - 1)), lev);
+
             // Solves Bx, By using Sx, Sy and chi
             ExplicitMGSolveBxBy(lev, WhichSlice::This);
         }
@@ -695,9 +753,15 @@ Hipace::SolveOneSlice (int islice, int step)
         m_multi_plasma.DoFieldIonization(lev, m_3D_geom[lev], m_fields);
     }
 
-    // Push plasma particles
+    // Push plasma particles, and deposit them on the next slice if it exists
+    const bool fused_plasma_push =
+        m_fuse_plasma_push_deposit && islice-1 >= m_3D_geom[0].Domain().smallEnd(Direction::z);
+    if (fused_plasma_push) {
+        m_multi_laser.UpdateLaserAabs(islice-1, current_N_level, m_fields, m_3D_geom,
+                                      WhichSlice::Next);
+    }
     for (int lev=0; lev<current_N_level; ++lev) {
-        m_multi_plasma.AdvanceParticles(m_fields, m_3D_geom, false, lev);
+        m_multi_plasma.AdvanceParticles(m_fields, m_3D_geom, false, lev, fused_plasma_push);
     }
 
     // get minimum beam acceleration on level 0
@@ -725,6 +789,18 @@ Hipace::SolveOneSlice (int islice, int step)
     m_multi_beam.shiftBeamSlices();
 
     m_multi_laser.ShiftLaserSlices(islice);
+
+    if (HipaceTracer::m_enabled) {
+        HipaceTracer::Counter("plasma particles pushed",
+            m_num_plasma_particles_pushed - num_plasma_particles_pushed_start);
+        HipaceTracer::Counter("beam particles pushed",
+            m_num_beam_particles_pushed - num_beam_particles_pushed_start);
+    }
+
+    // release all temporary buffers of this slice
+    The_Scratch_Arena()->Reset();
+    HipaceTracer::Counter("scratch arena usage [B]",
+        static_cast<double>(The_Scratch_Arena()->LastSliceUsage()));
 }
 
 void
@@ -915,10 +991,14 @@ Hipace::ExplicitMGSolveBxBy (const int lev, const int which_slice)
             m_hpmg[lev] = std::make_unique<hpmg::MultiGrid>(m_slice_geom[lev].CellSize(0),
                                                             m_slice_geom[lev].CellSize(1),
                                                             slicemf.boxArray()[0], 1);
+            m_hpmg[lev]->m_use_bicgstab = m_MG_use_bicgstab;
+            m_hpmg[lev]->m_use_mixed_precision = m_MG_use_mixed_precision;
         }
         const int max_iters = 200;
         m_hpmg[lev]->solve1(BxBy[0], SySx[0], Mult[0], m_MG_tolerance_rel, m_MG_tolerance_abs,
                             max_iters, m_MG_verbose);
+        HipaceTracer::Counter("hpmg iterations", m_hpmg[lev]->getNumIters());
+        m_MG_avg_iterations += m_hpmg[lev]->getNumIters();
     }
 
     if (lev==0) {
@@ -994,7 +1074,7 @@ Hipace::PredictorCorrectorLoopToSolveBxBy (const int islice, const int current_N
         for (int lev=0; lev<current_N_level; ++lev) {
             // Mixing the calculated B fields to the actual B field and shifting iterated B fields
             m_fields.MixAndShiftBfields(relative_Bfield_error, relative_Bfield_error_prev_iter,
-                                        m_predcorr_B_mixing_factor, lev);
+                                        m_predcorr_B_mixing_factor, i_iter, lev);
         }
 
         for (int lev=0; lev<current_N_level; ++lev) {
@@ -1072,7 +1152,7 @@ Hipace::InitDiagnostics (const int step)
         m_openpmd_writer.InitDiagnostics();
     }
     if (m_diags.hasBeamOutput(step, m_max_step, m_physical_time, m_max_time)) {
-        m_openpmd_writer.InitBeamData(m_multi_beam, getDiagBeamNames());
+        m_openpmd_writer.InitBeamData(m_multi_beam, getDiagBeamNames(), step, m_3D_geom[0]);
     }
 #endif
     m_diags.ResizeFDiagFAB(m_3D_geom, m_multi_laser.GetLaserGeom(),
@@ -1126,6 +1206,6 @@ void
 Hipace::FlushDiagnostics ()
 {
 #ifdef HIPACE_USE_OPENPMD
-    m_openpmd_writer.flush();
+    m_openpmd_writer.flush(m_diags.getFieldData());
 #endif
 }
@@ -0,0 +1,263 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "Hipace.H"
+#include "utils/HipaceProfilerWrapper.H"
+#include "utils/Parser.H"
+#include "utils/ScratchArena.H"
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+
+/** \brief Times the individual pieces of Hipace::SolveOneSlice in isolation on a synthetic
+ * setup (uniform plasma, flat-top beam) and writes the results as CSV.
+ *
+ * Each benchmark case builds a full Hipace instance, solves the first two slices to reach a
+ * realistic state, times every kernel bench.repetitions times on the following slice and
+ * finally solves the remaining slices so all communication buffers are completed.
+ */
+class HipaceBench
+{
+public:
+    /** parameters of one benchmark case */
+    struct Case {
+        int n_cell = 0;
+        int ppc = 0;
+        int depos_order_xy = 0;
+    };
+
+    /** Read the sweep parameters from the bench ParmParse prefix */
+    HipaceBench ()
+    {
+        amrex::ParmParse pp("bench");
+        queryWithParser(pp, "n_cell", m_n_cell);
+        queryWithParser(pp, "ppc", m_ppc);
+        queryWithParser(pp, "depos_order_xy", m_depos_order_xy);
+        queryWithParser(pp, "nz", m_nz);
+        queryWithParser(pp, "repetitions", m_repetitions);
+        queryWithParser(pp, "output_file", m_output_file);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_nz >= 3, "bench.nz must be at least 3");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_repetitions >= 1, "bench.repetitions must be positive");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(amrex::ParallelDescriptor::NProcs() == 1,
+            "hipace_bench must be run on a single MPI rank");
+    }
+
+    /** Run all cases of the sweep and write the CSV file */
+    void Run ()
+    {
+        std::ofstream ofs;
+        if (amrex::ParallelDescriptor::IOProcessor()) {
+            ofs.open(m_output_file);
+            ofs << "version,n_cell_x,n_cell_y,ppc,depos_order_xy,kernel,"
+                   "repetitions,time_mean_s,time_min_s,time_max_s\n";
+        }
+        for (int n_cell : m_n_cell) {
+            for (int ppc : m_ppc) {
+                for (int depos_order_xy : m_depos_order_xy) {
+                    RunCase(Case{n_cell, ppc, depos_order_xy}, ofs);
+                }
+            }
+        }
+    }
+
+private:
+    /** Add the synthetic input deck for one case to the global ParmParse table.
+     * Parameters that are swept are always overwritten, all others can be set by the user. */
+    void SetParameters (const Case& c)
+    {
+        amrex::ParmParse pp_amr("amr");
+        pp_amr.addarr("n_cell", std::vector<int>{c.n_cell, c.n_cell, m_nz});
+        amrex::ParmParse pph("hipace");
+        pph.add("depos_order_xy", c.depos_order_xy);
+        amrex::ParmParse pp_plasma("plasma");
+        pp_plasma.addarr("ppc", std::vector<int>{c.ppc, c.ppc});
+
+        if (m_defaults_set) return;
+        m_defaults_set = true;
+
+        auto add_default = [] (const std::string& prefix, const std::string& name,
+                               const std::vector<std::string>& val) {
+            amrex::ParmParse pp(prefix);
+            if (!pp.contains(name.c_str())) {
+                pp.addarr(name.c_str(), val);
+            }
+        };
+        add_default("hipace", "normalized_units", {"1"});
+        add_default("", "max_step", {"0"});
+        add_default("amr", "max_level", {"0"});
+        add_default("geometry", "prob_lo", {"-8.", "-8.", "-6."});
+        add_default("geometry", "prob_hi", {"8.", "8.", "6."});
+        add_default("boundary", "field", {"Dirichlet"});
+        add_default("boundary", "particle", {"Periodic"});
+        // the benchmark calls put_data and get_data on the same slice repeatedly
+        add_default("comms_buffer", "async_memcpy", {"0"});
+        add_default("beams", "names", {"beam"});
+        add_default("beam", "injection_type", {"fixed_ppc"});
+        add_default("beam", "profile", {"flattop"});
+        add_default("beam", "zmin", {"-6."});
+        add_default("beam", "zmax", {"6."});
+        add_default("beam", "radius", {"2."});
+        add_default("beam", "density", {"3."});
+        add_default("beam", "u_mean", {"0.", "0.", "2000."});
+        add_default("beam", "u_std", {"0.", "0.", "0."});
+        add_default("beam", "ppc", {"1", "1", "1"});
+        add_default("plasmas", "names", {"plasma"});
+        add_default("plasma", "density(x,y,z)", {"1."});
+        add_default("plasma", "u_mean", {"0.", "0.", "0."});
+        add_default("plasma", "element", {"electron"});
+    }
+
+    /** Time f over m_repetitions calls and append one line to the CSV file */
+    void Time (const Case& c, const std::string& kernel, std::ofstream& ofs,
+               const std::function<void()>& f)
+    {
+        double t_sum = 0.;
+        double t_min = std::numeric_limits<double>::max();
+        double t_max = 0.;
+        for (int rep = 0; rep < m_repetitions; ++rep) {
+            // release temporary buffers as at the end of every slice, this also synchronizes
+            The_Scratch_Arena()->Reset();
+            const double t_start = amrex::second();
+            f();
+            amrex::Gpu::streamSynchronize();
+            const double t = amrex::second() - t_start;
+            t_sum += t;
+            t_min = std::min(t_min, t);
+            t_max = std::max(t_max, t);
+        }
+        const double t_mean = t_sum / m_repetitions;
+        amrex::Print() << "    " << std::setw(24) << std::left << kernel << " "
+                       << t_mean << " s\n";
+        if (ofs.is_open()) {
+            ofs << Hipace::Version() << ',' << c.n_cell << ',' << c.n_cell << ',' << c.ppc << ','
+                << c.depos_order_xy << ',' << kernel << ',' << m_repetitions << ','
+                << t_mean << ',' << t_min << ',' << t_max << '\n';
+        }
+    }
+
+    /** Build a Hipace instance for one case and time all kernels */
+    void RunCase (const Case& c, std::ofstream& ofs)
+    {
+        amrex::Print() << "hipace_bench: n_cell = " << c.n_cell << ", ppc = " << c.ppc
+                       << ", depos_order_xy = " << c.depos_order_xy << "\n";
+
+        // field components are registered globally in Fields::AllocData
+        for (auto& comps : Comps) {
+            comps.clear();
+        }
+        N_Comps = 0;
+
+        SetParameters(c);
+
+        Hipace hipace;
+        hipace.InitData();
+
+        // same per-step initialization as in Hipace::Evolve for step 0
+        const int step = 0;
+        hipace.ResetAllQuantities();
+        hipace.m_physical_time = hipace.m_initial_time;
+        hipace.m_multi_plasma.InitData(hipace.m_slice_ba, hipace.m_slice_dm,
+                                       hipace.m_slice_geom, hipace.m_3D_geom);
+        hipace.m_multi_plasma.DepositNeutralizingBackground(
+            hipace.m_fields, WhichSlice::RhomJzIons, hipace.m_3D_geom, 0);
+        hipace.InitDiagnostics(step);
+
+        const int top = hipace.m_3D_geom[0].Domain().bigEnd(Direction::z);
+        const int bottom = hipace.m_3D_geom[0].Domain().smallEnd(Direction::z);
+
+        // solve two slices so that fields, plasma and the beam slices are in a realistic state
+        hipace.SolveOneSlice(top, step);
+        hipace.SolveOneSlice(top-1, step);
+        const int islice = top-2;
+
+        const bool do_rho = Hipace::m_deposit_rho || Hipace::m_deposit_rho_individual;
+        auto& geom = hipace.m_3D_geom;
+
+        Time(c, "plasma_deposition", ofs, [&] () {
+            hipace.m_multi_plasma.DepositCurrent(hipace.m_fields, WhichSlice::This,
+                true, false, do_rho, true, true, geom, 0);
+        });
+        Time(c, "explicit_deposition", ofs, [&] () {
+            hipace.InitializeSxSyWithBeam(0);
+            hipace.m_multi_plasma.ExplicitDeposition(hipace.m_fields, geom, 0);
+        });
+        Time(c, "fft_poisson_solve", ofs, [&] () {
+            hipace.m_fields.SolvePoissonPsiExmByEypBxEzBz(geom, 1);
+        });
+        Time(c, "hpmg_solve2", ofs, [&] () {
+            hipace.ExplicitMGSolveBxBy(0, WhichSlice::This);
+        });
+        if (!hipace.m_hpmg.empty() && hipace.m_hpmg[0]) {
+            // compare double and mixed precision V-cycles, starting from zero so both iterate
+            for (const bool mixed : {false, true}) {
+                Time(c, mixed ? "hpmg_solve2_mixed" : "hpmg_solve2_double", ofs, [&] () {
+                    hipace.m_fields.setVal(0., 0, WhichSlice::This, "Bx", "By");
+                    hipace.m_hpmg[0]->m_use_mixed_precision = mixed;
+                    hipace.ExplicitMGSolveBxBy(0, WhichSlice::This);
+                });
+            }
+            hipace.m_hpmg[0]->m_use_mixed_precision = Hipace::m_MG_use_mixed_precision;
+        }
+        Time(c, "plasma_push", ofs, [&] () {
+            hipace.m_multi_plasma.AdvanceParticles(hipace.m_fields, geom, false, 0);
+        });
+        if (Hipace::m_fuse_plasma_push_deposit) {
+            Time(c, "plasma_push_fused_deposition", ofs, [&] () {
+                hipace.m_multi_plasma.AdvanceParticles(hipace.m_fields, geom, false, 0, true);
+            });
+        }
+        Time(c, "beam_push", ofs, [&] () {
+            hipace.m_multi_beam.AdvanceBeamParticlesSlice(hipace.m_fields, geom, islice, 1);
+        });
+        Time(c, "multibuffer_pack_unpack", ofs, [&] () {
+            hipace.m_multi_buffer.put_data(islice, hipace.m_multi_beam, hipace.m_multi_laser,
+                                           WhichBeamSlice::This, false);
+            hipace.m_multi_buffer.get_data(islice, hipace.m_multi_beam, hipace.m_multi_laser,
+                                           WhichBeamSlice::This);
+        });
+
+        // finish the time step so all slices of the communication buffer are completed
+        for (int isl = islice; isl >= bottom; --isl) {
+            hipace.SolveOneSlice(isl, step);
+        }
+    }
+
+    /** transverse number of cells to sweep */
+    std::vector<int> m_n_cell {64, 128, 256};
+    /** plasma particles per cell in each transverse direction to sweep */
+    std::vector<int> m_ppc {1, 2};
+    /** transverse deposition orders to sweep */
+    std::vector<int> m_depos_order_xy {1, 2, 3};
+    /** number of longitudinal cells, must be at least 3 */
+    int m_nz = 8;
+    /** number of timed calls per kernel */
+    int m_repetitions = 20;
+    /** name of the CSV output file */
+    std::string m_output_file = "hipace_bench.csv";
+    /** whether the non-swept default parameters were already added */
+    bool m_defaults_set = false;
+};
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv,true,MPI_COMM_WORLD,Parser::setDefaultParams);
+    {
+        HIPACE_PROFILE("main()");
+        HipaceBench bench;
+        bench.Run();
+    }
+    HipaceTracer::Finalize();
+    amrex::Finalize();
+}
@@ -0,0 +1,117 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "InSituHistogram.H"
+#include "utils/Parser.H"
+
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+
+void
+InSituHistograms::ReadParameters (const std::string& name, const std::string& name_alt)
+{
+    amrex::ParmParse pp(name);
+    amrex::ParmParse pp_alt(name_alt);
+    queryWithParserAlt(pp, "insitu_histograms", m_names, pp_alt);
+
+    const amrex::Vector<std::string> quantity_names {"x", "y", "z", "ux", "uy", "uz", "gamma"};
+
+    int offset = 0;
+    for (const auto& hist_name : m_names) {
+        amrex::ParmParse pp_hist(name + "." + hist_name);
+        amrex::ParmParse pp_hist_alt(name_alt + "." + hist_name);
+        amrex::Vector<std::string> axes;
+        amrex::Vector<int> nbins;
+        amrex::Vector<amrex::Real> lo;
+        amrex::Vector<amrex::Real> hi;
+        getWithParserAlt(pp_hist, "axes", axes, pp_hist_alt);
+        getWithParserAlt(pp_hist, "bins", nbins, pp_hist_alt);
+        getWithParserAlt(pp_hist, "min", lo, pp_hist_alt);
+        getWithParserAlt(pp_hist, "max", hi, pp_hist_alt);
+
+        const int ndims = axes.size();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ndims >= 1 && ndims <= HistogramDescriptor::max_dims,
+            "In-situ histogram '" + hist_name + "' must have one or two axes");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(int(nbins.size()) == ndims && int(lo.size()) == ndims
+            && int(hi.size()) == ndims, "In-situ histogram '" + hist_name +
+            "': bins, min and max must have one entry per axis");
+
+        HistogramDescriptor desc;
+        desc.m_ndims = ndims;
+        desc.m_offset = offset;
+        int size = 1;
+        for (int dim = 0; dim < ndims; ++dim) {
+            const auto it = std::find(quantity_names.begin(), quantity_names.end(), axes[dim]);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(it != quantity_names.end(),
+                "Unknown in-situ histogram axis '" + axes[dim] +
+                "', must be one of x, y, z, ux, uy, uz or gamma");
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(nbins[dim] > 0 && hi[dim] > lo[dim],
+                "In-situ histogram '" + hist_name + "' must have bins > 0 and max > min");
+            desc.m_quantity[dim] = static_cast<int>(it - quantity_names.begin());
+            desc.m_nbins[dim] = nbins[dim];
+            desc.m_lo[dim] = lo[dim];
+            desc.m_inv_dbin[dim] = nbins[dim] / (hi[dim] - lo[dim]);
+            size *= nbins[dim];
+        }
+        offset += size;
+
+        m_desc.push_back(desc);
+        for (int dim = 0; dim < HistogramDescriptor::max_dims; ++dim) {
+            m_bins.push_back(dim < ndims ? nbins[dim] : 1);
+        }
+        for (int dim = 0; dim < HistogramDescriptor::max_dims; ++dim) {
+            m_ranges.push_back(dim < ndims ? lo[dim] : 0);
+        }
+        for (int dim = 0; dim < HistogramDescriptor::max_dims; ++dim) {
+            m_ranges.push_back(dim < ndims ? hi[dim] : 0);
+        }
+    }
+
+    m_desc_device.resize(m_desc.size());
+    amrex::Gpu::copy(amrex::Gpu::hostToDevice, m_desc.begin(), m_desc.end(),
+                     m_desc_device.begin());
+    m_data_device.resize(offset);
+    m_data_host.resize(offset);
+    Reset();
+}
+
+void
+InSituHistograms::AddToDataNodes (amrex::Vector<insitu_utils::DataNode>& all_data)
+{
+    if (empty()) return;
+
+    amrex::Gpu::copy(amrex::Gpu::deviceToHost, m_data_device.begin(), m_data_device.end(),
+                     m_data_host.begin());
+
+    constexpr int max_dims = HistogramDescriptor::max_dims;
+    amrex::Vector<insitu_utils::DataNode> hist_data;
+    for (int ih = 0; ih < m_names.size(); ++ih) {
+        const HistogramDescriptor& d = m_desc[ih];
+        const std::size_t ndims = d.m_ndims;
+        std::size_t size = 1;
+        for (int dim = 0; dim < d.m_ndims; ++dim) size *= d.m_nbins[dim];
+        // the bins of 2D histograms are stored row major with the first axis as the row
+        hist_data.emplace_back(m_names[ih], amrex::Vector<insitu_utils::DataNode>{
+            {"bins"  , &m_bins[max_dims*ih], ndims},
+            {"min"   , &m_ranges[2*max_dims*ih], ndims},
+            {"max"   , &m_ranges[2*max_dims*ih + max_dims], ndims},
+            {"sum(w)", &m_data_host[d.m_offset], size}
+        });
+    }
+    all_data.emplace_back("histograms", hist_data);
+}
+
+void
+InSituHistograms::Reset ()
+{
+    if (empty()) return;
+    amrex::Real* data = m_data_device.dataPtr();
+    const int size = static_cast<int>(m_data_device.size());
+    amrex::ParallelFor(size, [=] AMREX_GPU_DEVICE (int i) noexcept {
+        data[i] = 0;
+    });
+}
@@ -40,16 +40,36 @@ OpenPMDWriter::OpenPMDWriter ()
     }
     // overwrite output path by choice of the user
     queryWithParser(pp, "file_prefix", m_file_prefix);
+    queryWithParser(pp, "openpmd_async_write", m_async_write);
+    queryWithParser(pp, "openpmd_beam_chunk_size", m_beam_chunk_size);
 
     // temporary workaround until openPMD-viewer gets fixed
     amrex::ParmParse ppd("diagnostic");
     queryWithParser(ppd, "openpmd_viewer_u_workaround", m_openpmd_viewer_workaround);
 }
 
+OpenPMDWriter::~OpenPMDWriter ()
+{
+    WaitForChunkFlush();
+    WaitForAsyncFlush();
+}
+
 void
 OpenPMDWriter::InitDiagnostics ()
 {
-    HIPACE_PROFILE("OpenPMDWriter::InitDiagnostics()");
+    if (m_async_write) {
+        // The series is only created once the previous one is completely written,
+        // so that the openPMD backend is never used by two threads at the same time.
+        m_series_pending = true;
+        return;
+    }
+    CreateSeries();
+}
+
+void
+OpenPMDWriter::CreateSeries ()
+{
+    HIPACE_PROFILE("OpenPMDWriter::CreateSeries()");
 
     std::string filename = m_file_prefix + "/openpmd_%06T." + m_openpmd_backend;
 
@@ -59,6 +79,17 @@ OpenPMDWriter::InitDiagnostics ()
     // TODO: meta-data: author, mesh path, extensions, software
 }
 
+openPMD::Iteration
+OpenPMDWriter::GetIteration (const int output_step)
+{
+    if (m_series_pending) {
+        WaitForAsyncFlush();
+        CreateSeries();
+        m_series_pending = false;
+    }
+    return m_outputSeries->iterations[output_step];
+}
+
 void
 OpenPMDWriter::WriteDiagnostics (
     const amrex::Vector<FieldDiagnosticData>& field_diag, MultiBeam& a_multi_beam,
@@ -67,7 +98,10 @@ OpenPMDWriter::WriteDiagnostics (
     amrex::Vector<amrex::Geometry> const& geom3D,
     const OpenPMDWriterCallType call_type)
 {
-    openPMD::Iteration iteration = m_outputSeries->iterations[output_step];
+    // openPMD must not be used by two threads at the same time
+    WaitForChunkFlush();
+
+    openPMD::Iteration iteration = GetIteration(output_step);
     iteration.setTime(physical_time);
 
     if (call_type == OpenPMDWriterCallType::beams ) {
@@ -157,7 +191,8 @@ OpenPMDWriter::WriteFieldData (
 }
 
 void
-OpenPMDWriter::InitBeamData (MultiBeam& beams, const amrex::Vector< std::string > beamnames)
+OpenPMDWriter::InitBeamData (MultiBeam& beams, const amrex::Vector< std::string > beamnames,
+                             const int output_step, const amrex::Geometry& geom)
 {
     HIPACE_PROFILE("OpenPMDWriter::InitBeamData()");
 
@@ -165,6 +200,30 @@ OpenPMDWriter::InitBeamData (MultiBeam& beams, const amrex::Vector< std::string
     m_offset.resize(nbeams);
     m_uint64_beam_data.resize(nbeams);
     m_real_beam_data.resize(nbeams);
+    m_beam_output_step = output_step;
+    m_beam_geom = geom;
+    m_beam_declared_np.assign(nbeams, 0);
+    m_beam_staged_np.assign(nbeams, 0);
+    m_beam_is_setup.assign(nbeams, false);
+    m_spare_uint64_beam_data.resize(nbeams);
+    m_spare_real_beam_data.resize(nbeams);
+
+    auto alloc_uint64 = [] (std::size_t n) {
+        return std::shared_ptr<uint64_t>(
+            reinterpret_cast<uint64_t*>(amrex::The_Pinned_Arena()->alloc(sizeof(uint64_t)*n)),
+            [](uint64_t *p){
+                amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p));
+            });
+    };
+    auto alloc_real = [] (std::size_t n) {
+        return std::shared_ptr<amrex::ParticleReal>(
+            reinterpret_cast<amrex::ParticleReal*>(
+                amrex::The_Pinned_Arena()->alloc(sizeof(amrex::ParticleReal)*n)),
+            [](amrex::ParticleReal *p){
+                amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p));
+            });
+    };
+
     for (int ibeam = 0; ibeam < nbeams; ibeam++) {
 
         std::string name = beams.get_name(ibeam);
@@ -172,33 +231,27 @@ OpenPMDWriter::InitBeamData (MultiBeam& beams, const amrex::Vector< std::string
 
         // initialize beam IO on first slice
         const uint64_t np_total = beams.getBeam(ibeam).getTotalNumParticles();
+        m_beam_declared_np[ibeam] = np_total;
+
+        // with streaming output only two chunks are staged, otherwise the whole beam
+        const uint64_t np_buffer = m_beam_chunk_size > 0 ?
+            std::min<uint64_t>(m_beam_chunk_size, np_total) : np_total;
+
+        const std::size_t nreal = beams.getBeam(ibeam).m_do_spin_tracking ?
+            m_real_names.size() + m_real_names_spin.size() : m_real_names.size();
 
         m_uint64_beam_data[ibeam].resize(m_int_names.size());
+        for (auto& data : m_uint64_beam_data[ibeam]) data = alloc_uint64(np_buffer);
 
-        for (std::size_t idx=0; idx<m_uint64_beam_data[ibeam].size(); idx++) {
-            m_uint64_beam_data[ibeam][idx].reset(
-                reinterpret_cast<uint64_t*>(
-                    amrex::The_Pinned_Arena()->alloc(sizeof(uint64_t)*np_total)
-                ),
-                [](uint64_t *p){
-                    amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p));
-                });
-        }
+        m_real_beam_data[ibeam].resize(nreal);
+        for (auto& data : m_real_beam_data[ibeam]) data = alloc_real(np_buffer);
 
-        if (beams.getBeam(ibeam).m_do_spin_tracking) {
-            m_real_beam_data[ibeam].resize(m_real_names.size() + m_real_names_spin.size());
-        } else {
-            m_real_beam_data[ibeam].resize(m_real_names.size());
-        }
+        if (m_beam_chunk_size > 0) {
+            m_spare_uint64_beam_data[ibeam].resize(m_int_names.size());
+            for (auto& data : m_spare_uint64_beam_data[ibeam]) data = alloc_uint64(np_buffer);
 
-        for (std::size_t idx=0; idx<m_real_beam_data[ibeam].size(); idx++) {
-            m_real_beam_data[ibeam][idx].reset(
-                reinterpret_cast<amrex::ParticleReal*>(
-                    amrex::The_Pinned_Arena()->alloc(sizeof(amrex::ParticleReal)*np_total)
-                ),
-                [](amrex::ParticleReal *p){
-                    amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p));
-                });
+            m_spare_real_beam_data[ibeam].resize(nreal);
+            for (auto& data : m_spare_real_beam_data[ibeam]) data = alloc_real(np_buffer);
         }
 
         // if first slice of loop over slices, reset offset
@@ -231,6 +284,43 @@ OpenPMDWriter::WriteBeamParticleData (MultiBeam& beams, openPMD::Iteration itera
             real_names.insert(real_names.end(), m_real_names_spin.begin(), m_real_names_spin.end());
         }
 
+        if (m_beam_chunk_size > 0) {
+            // write the remaining staged particles
+            FlushBeamChunk(beams, ibeam);
+            WaitForChunkFlush();
+
+            const uint64_t np_declared = m_beam_declared_np[ibeam];
+            if (np_declared == 0) {
+                amrex::ErrorStream() << "WARNING: Beam '" << name
+                                     << "' has no particles! No output will be written.\n";
+                continue;
+            }
+
+            // The size of the records was declared with the initial number of particles,
+            // particles that were not written are filled with zero weight
+            const uint64_t np_pad = np_declared - m_offset[ibeam];
+            if (np_pad == 0) continue;
+            const uint64_t np_zero = std::min<uint64_t>(np_pad, m_beam_chunk_size);
+            std::shared_ptr<uint64_t> zero_uint64{new uint64_t[np_zero](),
+                                                  std::default_delete<uint64_t[]>()};
+            std::shared_ptr<amrex::ParticleReal> zero_real{new amrex::ParticleReal[np_zero](),
+                std::default_delete<amrex::ParticleReal[]>()};
+            for (uint64_t offset = m_offset[ibeam]; offset < np_declared; offset += np_zero) {
+                const uint64_t n = std::min(np_zero, np_declared - offset);
+                for (const auto& int_name : m_int_names) {
+                    auto [record_name, component_name] = utils::name2openPMD(int_name);
+                    beam_species[record_name][component_name].storeChunk(
+                        zero_uint64, {offset}, {n});
+                }
+                for (const auto& real_name : real_names) {
+                    auto [record_name, component_name] = utils::name2openPMD(real_name);
+                    beam_species[record_name][component_name].storeChunk(
+                        zero_real, {offset}, {n});
+                }
+            }
+            continue;
+        }
+
         // initialize beam IO on first slice
         AMREX_ALWAYS_ASSERT(m_offset[ibeam] <= beam.getTotalNumParticles());
         const uint64_t np_total = m_offset[ibeam];
@@ -287,34 +377,139 @@ OpenPMDWriter::CopyBeams (MultiBeam& beams, const amrex::Vector< std::string > b
         auto& beam = beams.getBeam(ibeam);
 
         const uint64_t np = beam.getNumParticles(WhichBeamSlice::This);
+        auto& soa = beam.getBeamSlice(WhichBeamSlice::This).GetStructOfArrays();
 
-        if (np != 0) {
-            // copy data from GPU to IO buffer
-            auto& soa = beam.getBeamSlice(WhichBeamSlice::This).GetStructOfArrays();
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            np == 0 || int(m_real_beam_data[ibeam].size()) == soa.NumRealComps(),
+            "List of real names in openPMD Writer class does not match the beam");
 
+        // copy n particles starting at src from GPU to the IO buffer at dst
+        auto copy_to_buffer = [&] (uint64_t src, uint64_t n, uint64_t dst) {
             for (std::size_t idx=0; idx<m_uint64_beam_data[ibeam].size(); idx++) {
                 amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost,
-                    soa.GetIdCPUData().begin(),
-                    soa.GetIdCPUData().begin() + np,
-                    m_uint64_beam_data[ibeam][idx].get() + m_offset[ibeam]);
+                    soa.GetIdCPUData().begin() + src,
+                    soa.GetIdCPUData().begin() + src + n,
+                    m_uint64_beam_data[ibeam][idx].get() + dst);
             }
 
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                int(m_real_beam_data[ibeam].size()) == soa.NumRealComps(),
-                "List of real names in openPMD Writer class does not match the beam");
-
             for (std::size_t idx=0; idx<m_real_beam_data[ibeam].size(); idx++) {
                 amrex::Gpu::copyAsync(amrex::Gpu::deviceToHost,
-                    soa.GetRealData(idx).begin(),
-                    soa.GetRealData(idx).begin() + np,
-                    m_real_beam_data[ibeam][idx].get() + m_offset[ibeam]);
+                    soa.GetRealData(idx).begin() + src,
+                    soa.GetRealData(idx).begin() + src + n,
+                    m_real_beam_data[ibeam][idx].get() + dst);
+            }
+        };
+
+        if (m_beam_chunk_size > 0) {
+            AMREX_ALWAYS_ASSERT(m_offset[ibeam] + m_beam_staged_np[ibeam] + np
+                                <= m_beam_declared_np[ibeam]);
+            // stage the slice in pieces, every full chunk is written in the background
+            for (uint64_t copied = 0; copied < np; ) {
+                const uint64_t n = std::min<uint64_t>(np - copied,
+                    m_beam_chunk_size - m_beam_staged_np[ibeam]);
+                copy_to_buffer(copied, n, m_beam_staged_np[ibeam]);
+                m_beam_staged_np[ibeam] += n;
+                copied += n;
+                if (m_beam_staged_np[ibeam] == uint64_t(m_beam_chunk_size)) {
+                    FlushBeamChunk(beams, ibeam);
+                }
             }
+            continue;
+        }
+
+        if (np != 0) {
+            copy_to_buffer(0, np, m_offset[ibeam]);
         }
 
         m_offset[ibeam] += np;
     }
 }
 
+void
+OpenPMDWriter::SetupStreamedBeam (MultiBeam& beams, const int ibeam)
+{
+    if (m_beam_is_setup[ibeam] || m_beam_declared_np[ibeam] == 0) return;
+    m_beam_is_setup[ibeam] = true;
+
+    auto& beam = beams.getBeam(ibeam);
+    amrex::Vector<std::string> real_names = m_real_names;
+    if (beam.m_do_spin_tracking) {
+        real_names.insert(real_names.end(), m_real_names_spin.begin(), m_real_names_spin.end());
+    }
+
+    // the final number of particles is not known yet, so the initial number is declared
+    openPMD::ParticleSpecies beam_species =
+        GetIteration(m_beam_output_step).particles[beams.get_name(ibeam)];
+    SetupPos(beam_species, beam, m_beam_declared_np[ibeam], m_beam_geom);
+    SetupRealProperties(beam_species, real_names, m_beam_declared_np[ibeam]);
+}
+
+void
+OpenPMDWriter::FlushBeamChunk (MultiBeam& beams, const int ibeam)
+{
+    HIPACE_PROFILE("OpenPMDWriter::FlushBeamChunk()");
+
+    // wait for the copies into the staging buffers
+    amrex::Gpu::streamSynchronize();
+    // openPMD must not be used by two threads at the same time
+    WaitForChunkFlush();
+
+    SetupStreamedBeam(beams, ibeam);
+
+    const uint64_t np = m_beam_staged_np[ibeam];
+    if (np == 0) return;
+
+    auto& beam = beams.getBeam(ibeam);
+    amrex::Vector<std::string> real_names = m_real_names;
+    if (beam.m_do_spin_tracking) {
+        real_names.insert(real_names.end(), m_real_names_spin.begin(), m_real_names_spin.end());
+    }
+    openPMD::ParticleSpecies beam_species =
+        GetIteration(m_beam_output_step).particles[beams.get_name(ibeam)];
+
+    for (std::size_t idx=0; idx<m_uint64_beam_data[ibeam].size(); idx++) {
+        uint64_t * const uint64_data = m_uint64_beam_data[ibeam][idx].get();
+
+        for (uint64_t i=0; i<np; ++i) {
+            uint64_t id = uint64_data[i];
+            // in the amrex format valid idcpus start with 1 and invalid with 0
+            amrex::ParticleIDWrapper{id}.make_invalid();
+            uint64_data[i] = id;
+        }
+
+        auto [record_name, component_name] = utils::name2openPMD(m_int_names[idx]);
+        beam_species[record_name][component_name].storeChunk(
+            m_uint64_beam_data[ibeam][idx], {m_offset[ibeam]}, {np});
+    }
+
+    for (std::size_t idx=0; idx<m_real_beam_data[ibeam].size(); idx++) {
+        auto [record_name, component_name] = utils::name2openPMD(real_names[idx]);
+        beam_species[record_name][component_name].storeChunk(
+            m_real_beam_data[ibeam][idx], {m_offset[ibeam]}, {np});
+    }
+
+    m_offset[ibeam] += np;
+    m_beam_staged_np[ibeam] = 0;
+
+    // the spare buffers are no longer used by openPMD since the last flush has finished
+    std::swap(m_uint64_beam_data[ibeam], m_spare_uint64_beam_data[ibeam]);
+    std::swap(m_real_beam_data[ibeam], m_spare_real_beam_data[ibeam]);
+
+    m_chunk_flush = std::async(std::launch::async,
+        [series = m_outputSeries.get()] () {
+            series->flush();
+        });
+}
+
+void
+OpenPMDWriter::WaitForChunkFlush ()
+{
+    if (m_chunk_flush.valid()) {
+        HIPACE_PROFILE("OpenPMDWriter::WaitForChunkFlush()");
+        m_chunk_flush.get();
+    }
+}
+
 void
 OpenPMDWriter::SetupPos (openPMD::ParticleSpecies& currSpecies, BeamParticleContainer& beam,
                          const unsigned long long& np, const amrex::Geometry& geom)
@@ -428,16 +623,60 @@ OpenPMDWriter::SetupRealProperties (openPMD::ParticleSpecies& currSpecies,
     } // end for NumSoARealAttributes
 }
 
-void OpenPMDWriter::flush ()
+void OpenPMDWriter::flush (amrex::Vector<FieldDiagnosticData>& field_diag)
 {
     amrex::Gpu::streamSynchronize();
-    m_uint64_beam_data.resize(0);
-    m_real_beam_data.resize(0);
-    if (m_outputSeries) {
-        HIPACE_PROFILE("OpenPMDWriter::flush()");
-        m_outputSeries->flush();
+    WaitForChunkFlush();
+    m_spare_uint64_beam_data.clear();
+    m_spare_real_beam_data.clear();
+    if (!m_async_write || !m_outputSeries) {
+        m_uint64_beam_data.resize(0);
+        m_real_beam_data.resize(0);
+        if (m_outputSeries) {
+            HIPACE_PROFILE("OpenPMDWriter::flush()");
+            m_outputSeries->flush();
+        }
+        m_outputSeries.reset();
+        return;
     }
+
+    HIPACE_PROFILE("OpenPMDWriter::flush()");
+
+    // only one flush can be in flight
+    WaitForAsyncFlush();
+
+    // The openPMD series only holds pointers to the IO buffers, which now belong to the
+    // background flush. The buffers of the previous flush are reused for the next output.
+    m_async_uint64_beam_data = std::move(m_uint64_beam_data);
+    m_async_real_beam_data = std::move(m_real_beam_data);
+    m_uint64_beam_data.clear();
+    m_real_beam_data.clear();
+    m_async_F.resize(field_diag.size());
+    m_async_F_laser.resize(field_diag.size());
+    for (int i=0; i<field_diag.size(); ++i) {
+        if (field_diag[i].m_has_field) {
+            std::swap(field_diag[i].m_F, m_async_F[i]);
+            std::swap(field_diag[i].m_F_laser, m_async_F_laser[i]);
+            field_diag[i].m_has_field = false;
+        }
+    }
+
+    m_async_flush = std::async(std::launch::async,
+        [series = std::move(m_outputSeries)] () mutable {
+            series->flush();
+            series.reset();
+        });
     m_outputSeries.reset();
 }
 
+void OpenPMDWriter::WaitForAsyncFlush ()
+{
+    if (m_async_flush.valid()) {
+        HIPACE_PROFILE("OpenPMDWriter::WaitForAsyncFlush()");
+        m_async_flush.get();
+        m_async_uint64_beam_data.clear();
+        m_async_real_beam_data.clear();
+    }
+}
+
 #endif // HIPACE_USE_OPENPMD
@@ -20,9 +20,6 @@
 #include "utils/GPUUtil.H"
 #include "utils/InsituUtil.H"
 #include "particles/particles_utils/ShapeFactors.H"
-#ifdef HIPACE_USE_OPENPMD
-#   include <openPMD/auxiliary/Filesystem.hpp>
-#endif
 
 using namespace amrex::literals;
 
@@ -38,6 +35,7 @@ Fields::Fields (const int nlev)
     m_poisson_solver_str = "FFTDirichletDirect";
 #endif
     queryWithParser(ppf, "poisson_solver", m_poisson_solver_str);
+    queryWithParser(ppf, "poisson_batch_solve", m_poisson_batch_solve);
     queryWithParser(ppf, "insitu_period", m_insitu_period);
     queryWithParser(ppf, "insitu_file_prefix", m_insitu_file_prefix);
     queryWithParser(ppf, "do_symmetrize", m_do_symmetrize);
@@ -75,6 +73,16 @@ Fields::AllocData (
 
             int isl = WhichSlice::Next;
             Comps[isl].multi_emplace(N_Comps, "jx_beam", "jy_beam");
+            if (Hipace::m_fuse_plasma_push_deposit) {
+                // plasma current of the next slice, deposited in the plasma push
+                Comps[isl].multi_emplace(N_Comps, "jx", "jy", "chi", "rhomjz");
+                if (Hipace::m_use_laser) {
+                    Comps[isl].multi_emplace(N_Comps, "aabs");
+                }
+                if (Hipace::m_deposit_rho) {
+                    Comps[isl].multi_emplace(N_Comps, "rho");
+                }
+            }
 
             isl = WhichSlice::This;
             // (Bx, By), (Sy, Sx) and (chi, chi2) adjacent for explicit solver
@@ -102,6 +110,10 @@ Fields::AllocData (
 
             isl = WhichSlice::Previous;
             Comps[isl].multi_emplace(N_Comps, "jx_beam", "jy_beam");
+            if (Hipace::m_MG_initial_guess_order >= 1) {
+                // history of Bx and By for the initial guess of the MG solver
+                Comps[isl].multi_emplace(N_Comps, "Bx", "By");
+            }
 
             isl = WhichSlice::RhomJzIons;
             if (m_any_neutral_background) {
@@ -118,7 +130,10 @@ Fields::AllocData (
             // empty
 
             isl = WhichSlice::PCPrevIter;
-            // empty
+            if (Hipace::m_MG_initial_guess_order >= 2) {
+                // history of Bx and By for the initial guess of the MG solver
+                Comps[isl].multi_emplace(N_Comps, "Bx", "By");
+            }
 
         } else {
             // predictor-corrector:
@@ -159,6 +174,15 @@ Fields::AllocData (
 
             isl = WhichSlice::PCIter;
             Comps[isl].multi_emplace(N_Comps, "Bx", "By");
+            if (Hipace::m_predcorr_anderson_depth > 0) {
+                // residual of the last iteration and history for Anderson mixing
+                Comps[isl].multi_emplace(N_Comps, "Bx_res", "By_res");
+                for (int i=0; i<Hipace::m_predcorr_anderson_depth; ++i) {
+                    Comps[isl].multi_emplace(N_Comps,
+                        "Bx_dB" + std::to_string(i), "By_dB" + std::to_string(i),
+                        "Bx_dres" + std::to_string(i), "By_dres" + std::to_string(i));
+                }
+            }
 
             isl = WhichSlice::PCPrevIter;
             Comps[isl].multi_emplace(N_Comps, "Bx", "By");
@@ -173,14 +197,38 @@ Fields::AllocData (
         m_slices[lev].setVal(0._rt);
     }
 
+    if (Hipace::m_verbose >= 1) {
+        // Every WhichSlice only allocates the components it uses,
+        // so the footprint per transverse cell is N_Comps Reals.
+        if (lev == 0) {
+            const std::array<std::string, WhichSlice::N> slice_names {
+                "Next", "This", "Previous", "RhomJzIons", "Salame", "PCIter", "PCPrevIter"};
+            amrex::Print() << "Field slice components:";
+            for (int isl=0; isl<WhichSlice::N; ++isl) {
+                if (Comps[isl].size() > 0) {
+                    amrex::Print() << " " << slice_names[isl] << " " << Comps[isl].size();
+                }
+            }
+            amrex::Print() << ", total " << N_Comps << " ("
+                           << N_Comps * sizeof(amrex::Real) << " bytes per transverse cell)\n";
+        }
+        // the levels differ in their number of transverse cells, slice_ba has one box
+        const amrex::Box slice_box = amrex::grow(slice_ba[0], m_slices_nguards);
+        amrex::Print() << "Field slices on level " << lev << ": "
+                       << N_Comps * sizeof(amrex::Real) * slice_box.numPts() / (1024.*1024.)
+                       << " MiB including guard cells\n";
+    }
+
     // The Poisson solver operates on transverse slices only.
     // The constructor takes the BoxArray and the DistributionMap of a slice,
     // so the FFTPlans are built on a slice.
+    // Psi, Ez and Bz can be solved in one batch.
+    const int poisson_batch_size = m_poisson_batch_solve ? 3 : 1;
     if (m_poisson_solver_str == "FFTDirichletDirect"){
         m_poisson_solver.push_back(std::unique_ptr<FFTPoissonSolverDirichletDirect>(
             new FFTPoissonSolverDirichletDirect(getSlices(lev).boxArray(),
                                                 getSlices(lev).DistributionMap(),
-                                                geom)) );
+                                                geom, poisson_batch_size)) );
     } else if (m_poisson_solver_str == "FFTDirichletExpanded"){
         m_poisson_solver.push_back(std::unique_ptr<FFTPoissonSolverDirichletExpanded>(
             new FFTPoissonSolverDirichletExpanded(getSlices(lev).boxArray(),
@@ -195,7 +243,7 @@ Fields::AllocData (
         m_poisson_solver.push_back(std::unique_ptr<FFTPoissonSolverPeriodic>(
             new FFTPoissonSolverPeriodic(getSlices(lev).boxArray(),
                                          getSlices(lev).DistributionMap(),
-                                         geom))  );
+                                         geom, poisson_batch_size))  );
     } else if (m_poisson_solver_str == "MGDirichlet") {
         m_poisson_solver.push_back(std::unique_ptr<MGPoissonSolverDirichlet>(
             new MGPoissonSolverDirichlet(getSlices(lev).boxArray(),
@@ -553,8 +601,21 @@ Fields::InitializeSlices (int lev, int islice, const amrex::Vector<amrex::Geomet
         // jx, jy, jx_beam and jy_beam on WhichSlice::This:
         // shifted from the previous WhichSlice::Next
         // with jx and jy initially set to jx_beam and jy_beam
-        setVal(0., lev, WhichSlice::This, "chi", "Sy", "Sx", "ExmBy", "EypBx", "jz_beam", "rhomjz");
+        // (plus the plasma current if it was deposited in the plasma push)
+        setVal(0., lev, WhichSlice::This, "Sy", "Sx", "ExmBy", "EypBx", "jz_beam");
         setVal(0., lev, WhichSlice::Next, "jx_beam", "jy_beam");
+        // the plasma contribution to chi and rhomjz is shifted from WhichSlice::Next
+        // if it was deposited in the plasma push, except on the first slice
+        const bool first_slice = islice == geom[lev].Domain().bigEnd(Direction::z);
+        if (!Hipace::m_fuse_plasma_push_deposit || first_slice) {
+            setVal(0., lev, WhichSlice::This, "chi", "rhomjz");
+        }
+        if (Hipace::m_fuse_plasma_push_deposit) {
+            setVal(0., lev, WhichSlice::Next, "jx", "jy", "chi", "rhomjz");
+            if (Hipace::m_deposit_rho) {
+                setVal(0., lev, WhichSlice::Next, "rho");
+            }
+        }
         if (Hipace::m_do_beam_jz_minus_rho) {
             setVal(0., lev, WhichSlice::This, "rhomjz_beam");
         }
@@ -575,7 +636,8 @@ Fields::InitializeSlices (int lev, int islice, const amrex::Vector<amrex::Geomet
             setVal(0., lev, WhichSlice::This, "chi");
         }
     }
-    if (Hipace::m_deposit_rho) {
+    if (Hipace::m_deposit_rho && (!Hipace::m_fuse_plasma_push_deposit ||
+                                  islice == geom[lev].Domain().bigEnd(Direction::z))) {
         setVal(0., lev, WhichSlice::This, "rho");
     }
     if (Hipace::m_deposit_rho_individual) {
@@ -597,6 +659,15 @@ Fields::ShiftSlices (int lev)
         shift(lev, WhichSlice::Previous, WhichSlice::This, "jx_beam", "jy_beam");
         duplicate(lev, WhichSlice::This, {"jx_beam", "jy_beam", "jx"     , "jy"     },
                        WhichSlice::Next, {"jx_beam", "jy_beam", "jx_beam", "jy_beam"});
+        if (Hipace::m_fuse_plasma_push_deposit) {
+            // plasma current of the next slice was already deposited in the plasma push
+            add(lev, WhichSlice::This, {"jx", "jy"}, WhichSlice::Next, {"jx", "jy"});
+            duplicate(lev, WhichSlice::This, {"chi", "rhomjz"},
+                           WhichSlice::Next, {"chi", "rhomjz"});
+            if (Hipace::m_deposit_rho) {
+                duplicate(lev, WhichSlice::This, {"rho"}, WhichSlice::Next, {"rho"});
+            }
+        }
     } else {
         shift(lev, WhichSlice::PCPrevIter, WhichSlice::Previous, "Bx", "By");
         shift(lev, WhichSlice::Previous, WhichSlice::This, "Bx", "By", "jx", "jy");
@@ -883,38 +954,49 @@ Fields::SolvePoissonPsiExmByEypBxEzBz (amrex::Vector<amrex::Geometry> const& geo
         amrex::MultiFab lhs_Ez  = getField(lev, WhichSlice::This, "Ez");
         amrex::MultiFab lhs_Bz  = getField(lev, WhichSlice::This, "Bz");
 
+        // If supported, the three right-hand sides are stored in different components of the
+        // staging area and solved together, otherwise they are solved one after the other.
+        const bool batched = m_poisson_solver[lev]->BatchSize() == 3;
+        const int ibatch_Psi = 0;
+        const int ibatch_Ez = batched ? 1 : 0;
+        const int ibatch_Bz = batched ? 2 : 0;
+
         // Psi: right-hand side 1/episilon0 * -(rho-Jz/c)
-        Multiply(getStagingArea(lev),
+        Multiply(getStagingArea(lev, ibatch_Psi),
             -1._rt/(phys_const.ep0), getField(lev, WhichSlice::This, "rhomjz"));
 
-        SetBoundaryCondition(geom, lev, WhichSlice::This, "Psi", getStagingArea(lev),
+        SetBoundaryCondition(geom, lev, WhichSlice::This, "Psi", getStagingArea(lev, ibatch_Psi),
             m_poisson_solver[lev]->BoundaryOffset(), m_poisson_solver[lev]->BoundaryFactor());
 
-        m_poisson_solver[lev]->SolvePoissonEquation(lhs_Psi);
+        if (!batched) m_poisson_solver[lev]->SolvePoissonEquation(lhs_Psi);
 
         // Ez: right-hand side 1/(episilon0 *c0 )*(d_x(jx) + d_y(jy))
-        LinCombination(getStagingArea(lev),
+        LinCombination(getStagingArea(lev, ibatch_Ez),
             1._rt/(phys_const.ep0*phys_const.c),
             derivative<Direction::x>{getField(lev, WhichSlice::This, "jx"), geom[lev]},
             1._rt/(phys_const.ep0*phys_const.c),
             derivative<Direction::y>{getField(lev, WhichSlice::This, "jy"), geom[lev]});
 
-        SetBoundaryCondition(geom, lev, WhichSlice::This, "Ez", getStagingArea(lev),
+        SetBoundaryCondition(geom, lev, WhichSlice::This, "Ez", getStagingArea(lev, ibatch_Ez),
             m_poisson_solver[lev]->BoundaryOffset(), m_poisson_solver[lev]->BoundaryFactor());
 
-        m_poisson_solver[lev]->SolvePoissonEquation(lhs_Ez);
+        if (!batched) m_poisson_solver[lev]->SolvePoissonEquation(lhs_Ez);
 
         // Bz: right-hand side mu_0*(d_y(jx) - d_x(jy))
-        LinCombination(getStagingArea(lev),
+        LinCombination(getStagingArea(lev, ibatch_Bz),
             phys_const.mu0,
             derivative<Direction::y>{getField(lev, WhichSlice::This, "jx"), geom[lev]},
             -phys_const.mu0,
             derivative<Direction::x>{getField(lev, WhichSlice::This, "jy"), geom[lev]});
 
-        SetBoundaryCondition(geom, lev, WhichSlice::This, "Bz", getStagingArea(lev),
+        SetBoundaryCondition(geom, lev, WhichSlice::This, "Bz", getStagingArea(lev, ibatch_Bz),
             m_poisson_solver[lev]->BoundaryOffset(), m_poisson_solver[lev]->BoundaryFactor());
 
-        m_poisson_solver[lev]->SolvePoissonEquation(lhs_Bz);
+        if (batched) {
+            m_poisson_solver[lev]->SolvePoissonEquationBatched({&lhs_Psi, &lhs_Ez, &lhs_Bz});
+        } else {
+            m_poisson_solver[lev]->SolvePoissonEquation(lhs_Bz);
+        }
     }
 
     EnforcePeriodic(false, {Comps[WhichSlice::This]["Psi"],
@@ -1170,16 +1252,69 @@ Fields::InitialBfieldGuess (const amrex::Real relative_Bfield_error,
         Comps[WhichSlice::This]["Bx"], 2, m_slices_nguards);
 }
 
+void
+Fields::ExtrapolateBfieldGuess (const int order, const int lev)
+{
+    /* Sets the initial guess of the B field by polynomial extrapolation from up to
+     * three previous slices
+     */
+    const int depth = Hipace::m_MG_initial_guess_order;
+    if (depth == 0) return;
+
+    HIPACE_PROFILE("Fields::ExtrapolateBfieldGuess()");
+
+    AMREX_ALWAYS_ASSERT(order <= depth);
+    AMREX_ALWAYS_ASSERT(Comps[WhichSlice::This]["Bx"]+1==Comps[WhichSlice::This]["By"]);
+    AMREX_ALWAYS_ASSERT(Comps[WhichSlice::Previous]["Bx"]+1==Comps[WhichSlice::Previous]["By"]);
+
+    const int bx_this = Comps[WhichSlice::This]["Bx"];
+    const int bx_prev = Comps[WhichSlice::Previous]["Bx"];
+    const int bx_prev2 = depth >= 2 ? Comps[WhichSlice::PCPrevIter]["Bx"] : bx_prev;
+
+    amrex::MultiFab& slicemf = getSlices(lev);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for (amrex::MFIter mfi(slicemf, DfltMfiTlng); mfi.isValid(); ++mfi) {
+        const Array3<amrex::Real> arr = slicemf.array(mfi);
+        amrex::ParallelFor(to2D(mfi.growntilebox()), 2,
+            [=] AMREX_GPU_DEVICE(int i, int j, int n) noexcept
+            {
+                const amrex::Real b1 = arr(i, j, bx_this + n);
+                const amrex::Real b2 = arr(i, j, bx_prev + n);
+                const amrex::Real b3 = arr(i, j, bx_prev2 + n);
+                if (order == 1) {
+                    arr(i, j, bx_this + n) = 2._rt * b1 - b2;
+                } else if (order == 2) {
+                    arr(i, j, bx_this + n) = 3._rt * b1 - 3._rt * b2 + b3;
+                }
+                if (depth >= 2) {
+                    arr(i, j, bx_prev2 + n) = b2;
+                }
+                arr(i, j, bx_prev + n) = b1;
+            });
+    }
+}
+
 void
 Fields::MixAndShiftBfields (const amrex::Real relative_Bfield_error,
                             const amrex::Real relative_Bfield_error_prev_iter,
-                            const amrex::Real predcorr_B_mixing_factor, const int lev)
+                            const amrex::Real predcorr_B_mixing_factor, const int i_iter,
+                            const int lev)
 {
     /* Mixes the B field according to B = a*B + (1-a)*( c*B_iter + d*B_prev_iter),
      * with a,c,d mixing coefficients.
      */
     HIPACE_PROFILE("Fields::MixAndShiftBfields()");
 
+    if (Hipace::m_predcorr_anderson_depth > 0) {
+        AndersonMixBfields(predcorr_B_mixing_factor, i_iter, lev);
+        /* Shifting the B field from the current iteration to the previous iteration */
+        duplicate(lev, WhichSlice::PCPrevIter, {"Bx", "By"}, WhichSlice::PCIter, {"Bx", "By"});
+        return;
+    }
+
     /* Mixing factors to mix the current and previous iteration of the B field */
     amrex::Real weight_B_iter;
     amrex::Real weight_B_prev_iter;
@@ -1225,6 +1360,108 @@ Fields::MixAndShiftBfields (const amrex::Real relative_Bfield_error,
     duplicate(lev, WhichSlice::PCPrevIter, {"Bx", "By"}, WhichSlice::PCIter, {"Bx", "By"});
 }
 
+void
+Fields::AndersonMixBfields (const amrex::Real predcorr_B_mixing_factor, const int i_iter,
+                            const int lev)
+{
+    /* Anderson mixing (type II) of the fixed point iteration B -> G(B) = B_iter with
+     * residual F = G(B) - B. With the differences dB_i and dF_i of the last n iterations
+     * the new guess is
+     * B = B + a*F - sum_i gamma_i * (dB_i + a*dF_i),
+     * where gamma minimizes |F - sum_i gamma_i * dF_i|.
+     */
+    HIPACE_PROFILE("Fields::AndersonMixBfields()");
+
+    const int depth = Hipace::m_predcorr_anderson_depth;
+    const int n_hist = std::min(i_iter - 1, depth);
+    const amrex::Real a = predcorr_B_mixing_factor;
+
+    amrex::MultiFab& slicemf = getSlices(lev);
+
+    const int B = Comps[WhichSlice::This]["Bx"];
+    const int B_iter = Comps[WhichSlice::PCIter]["Bx"];
+    const int res = Comps[WhichSlice::PCIter]["Bx_res"];
+    // B of WhichSlice::PCPrevIter is overwritten at the end of MixAndShiftBfields,
+    // so it can be used to store the step of this iteration
+    const int step = Comps[WhichSlice::PCPrevIter]["Bx"];
+    auto dB = [&] (int i) { return Comps[WhichSlice::PCIter]["Bx_dB" + std::to_string(i)]; };
+    auto dres = [&] (int i) { return Comps[WhichSlice::PCIter]["Bx_dres" + std::to_string(i)]; };
+
+    AMREX_ALWAYS_ASSERT(B+1==Comps[WhichSlice::This]["By"]);
+    AMREX_ALWAYS_ASSERT(res+1==Comps[WhichSlice::PCIter]["By_res"]);
+    AMREX_ALWAYS_ASSERT(step+1==Comps[WhichSlice::PCPrevIter]["By"]);
+
+    if (i_iter > 1) {
+        // complete the newest history entry: dF = F_new - F_old, dB was stored last iteration
+        const int slot = (i_iter - 2) % depth;
+        amrex::MultiFab::LinComb(slicemf,
+            1._rt, slicemf, B_iter, -1._rt, slicemf, B, dres(slot), 2, m_slices_nguards);
+        amrex::MultiFab::Saxpy(slicemf, -1._rt, slicemf, res, dres(slot), 2, m_slices_nguards);
+    }
+
+    // residual F = B_iter - B
+    amrex::MultiFab::LinComb(slicemf,
+        1._rt, slicemf, B_iter, -1._rt, slicemf, B, res, 2, m_slices_nguards);
+
+    // solve the normal equations (dF^T dF) gamma = dF^T F of the least squares problem
+    amrex::Vector<amrex::Real> gamma(n_hist, 0._rt);
+    if (n_hist > 0) {
+        amrex::Vector<amrex::Real> mat(n_hist*n_hist);
+        for (int i=0; i<n_hist; ++i) {
+            for (int j=i; j<n_hist; ++j) {
+                mat[i*n_hist+j] = mat[j*n_hist+i] = amrex::MultiFab::Dot(
+                    slicemf, dres(i), slicemf, dres(j), 2, 0, true);
+            }
+            gamma[i] = amrex::MultiFab::Dot(slicemf, dres(i), slicemf, res, 2, 0, true);
+        }
+
+        // Gaussian elimination with partial pivoting. If the history is (nearly) linearly
+        // dependent it is not used in this iteration.
+        amrex::Real trace = 0._rt;
+        for (int i=0; i<n_hist; ++i) trace += mat[i*n_hist+i];
+        bool singular = !(trace > 0._rt);
+        for (int k=0; k<n_hist && !singular; ++k) {
+            int piv = k;
+            for (int i=k+1; i<n_hist; ++i) {
+                if (std::abs(mat[i*n_hist+k]) > std::abs(mat[piv*n_hist+k])) piv = i;
+            }
+            if (std::abs(mat[piv*n_hist+k]) <= 1.e-10_rt * trace) {
+                singular = true;
+                break;
+            }
+            if (piv != k) {
+                for (int j=0; j<n_hist; ++j) std::swap(mat[k*n_hist+j], mat[piv*n_hist+j]);
+                std::swap(gamma[k], gamma[piv]);
+            }
+            for (int i=k+1; i<n_hist; ++i) {
+                const amrex::Real f = mat[i*n_hist+k] / mat[k*n_hist+k];
+                for (int j=k; j<n_hist; ++j) mat[i*n_hist+j] -= f * mat[k*n_hist+j];
+                gamma[i] -= f * gamma[k];
+            }
+        }
+        if (singular) {
+            for (auto& g : gamma) g = 0._rt;
+        } else {
+            for (int k=n_hist-1; k>=0; --k) {
+                for (int j=k+1; j<n_hist; ++j) gamma[k] -= mat[k*n_hist+j] * gamma[j];
+                gamma[k] /= mat[k*n_hist+k];
+            }
+        }
+    }
+
+    // step = a*F - sum_i gamma_i * (dB_i + a*dF_i)
+    amrex::MultiFab::LinComb(slicemf,
+        a, slicemf, res, 0._rt, slicemf, res, step, 2, m_slices_nguards);
+    for (int i=0; i<n_hist; ++i) {
+        amrex::MultiFab::Saxpy(slicemf, -gamma[i], slicemf, dB(i), step, 2, m_slices_nguards);
+        amrex::MultiFab::Saxpy(slicemf, -gamma[i]*a, slicemf, dres(i), step, 2, m_slices_nguards);
+    }
+
+    // B = B + step, and store the step as dB of the next history entry
+    amrex::MultiFab::Saxpy(slicemf, 1._rt, slicemf, step, B, 2, m_slices_nguards);
+    amrex::MultiFab::Copy(slicemf, slicemf, step, dB((i_iter - 1) % depth), 2, m_slices_nguards);
+}
+
 amrex::Real
 Fields::ComputeRelBFieldError (const int which_slice, const int which_slice_iter,
                                const amrex::Vector<amrex::Geometry>& geom,
@@ -1353,20 +1590,6 @@ Fields::InSituWriteToFile (int step, amrex::Real time, const amrex::Geometry& ge
     if (!utils::doDiagnostics(m_insitu_period, step, max_step, time, max_time)) return;
     HIPACE_PROFILE("Fields::InSituWriteToFile()");
 
-#ifdef HIPACE_USE_OPENPMD
-    // create subdirectory
-    openPMD::auxiliary::create_directories(m_insitu_file_prefix);
-#endif
-
-    // zero pad the rank number;
-    std::string::size_type n_zeros = 4;
-    std::string rank_num = std::to_string(amrex::ParallelDescriptor::MyProc());
-    std::string pad_rank_num = std::string(n_zeros-std::min(rank_num.size(), n_zeros),'0')+rank_num;
-
-    // open file
-    std::ofstream ofs{m_insitu_file_prefix + "/reduced_fields." + pad_rank_num + ".txt",
-        std::ofstream::out | std::ofstream::app | std::ofstream::binary};
-
     const int nslices_int = geom3D.Domain().length(2);
     const std::size_t nslices = static_cast<std::size_t>(nslices_int);
     const int is_normalized_units = Hipace::m_normalized_units;
@@ -1404,23 +1627,7 @@ Fields::InSituWriteToFile (int step, amrex::Real time, const amrex::Geometry& ge
         }}
     };
 
-    if (ofs.tellp() == 0) {
-        // write JSON header containing a NumPy structured datatype
-        insitu_utils::write_header(all_data, ofs);
-    }
-
-    // write binary data according to datatype in header
-    insitu_utils::write_data(all_data, ofs);
-
-    // close file
-    ofs.close();
-    // assert no file errors
-#ifdef HIPACE_USE_OPENPMD
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu field diagnostics");
-#else
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu field diagnostics. "
-        "Maybe the specified subdirectory does not exist");
-#endif
+    Hipace::GetInstance().m_insitu_writer.Write(m_insitu_file_prefix, "fields", step, all_data);
 
     // reset arrays for insitu data
     for (auto& x : m_insitu_rdata) x = 0.;
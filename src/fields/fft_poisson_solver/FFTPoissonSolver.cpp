@@ -15,3 +15,9 @@ FFTPoissonSolver::StagingArea ()
 {
     return m_stagingArea;
 }
+
+void
+FFTPoissonSolver::SolvePoissonEquationBatched (amrex::Vector<amrex::MultiFab*> const&)
+{
+    amrex::Abort("Batched Poisson solve is not supported by this Poisson solver");
+}
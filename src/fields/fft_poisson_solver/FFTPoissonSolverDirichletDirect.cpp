@@ -16,15 +16,17 @@
 FFTPoissonSolverDirichletDirect::FFTPoissonSolverDirichletDirect (
     amrex::BoxArray const& realspace_ba,
     amrex::DistributionMapping const& dm,
-    amrex::Geometry const& gm )
+    amrex::Geometry const& gm,
+    const int batch_size )
 {
-    define(realspace_ba, dm, gm);
+    define(realspace_ba, dm, gm, batch_size);
 }
 
 void
 FFTPoissonSolverDirichletDirect::define (amrex::BoxArray const& a_realspace_ba,
                                          amrex::DistributionMapping const& dm,
-                                         amrex::Geometry const& gm )
+                                         amrex::Geometry const& gm,
+                                         const int batch_size )
 {
     HIPACE_PROFILE("FFTPoissonSolverDirichletDirect::define()");
     using namespace amrex::literals;
@@ -36,8 +38,9 @@ FFTPoissonSolverDirichletDirect::define (amrex::BoxArray const& a_realspace_ba,
     // These arrays will store the data just before/after the FFT
     // The stagingArea is also created from 0 to nx, because the real space array may have
     // an offset for levels > 0
-    m_stagingArea = amrex::MultiFab(a_realspace_ba, dm, 1, 0);
-    m_tmpSpectralField = amrex::MultiFab(a_realspace_ba, dm, 1, 0);
+    m_batch_size = batch_size;
+    m_stagingArea = amrex::MultiFab(a_realspace_ba, dm, m_batch_size, 0);
+    m_tmpSpectralField = amrex::MultiFab(a_realspace_ba, dm, m_batch_size, 0);
     m_eigenvalue_matrix = amrex::MultiFab(a_realspace_ba, dm, 1, 0);
     m_stagingArea.setVal(0.0); // this is not required
     m_tmpSpectralField.setVal(0.0);
@@ -86,14 +89,28 @@ FFTPoissonSolverDirichletDirect::define (amrex::BoxArray const& a_realspace_ba,
     // Allocate and initialize the FFT plans
     std::size_t fwd_area = m_forward_fft.Initialize(FFTType::R2R_2D, fft_size[0], fft_size[1]);
     std::size_t bkw_area = m_backward_fft.Initialize(FFTType::R2R_2D, fft_size[0], fft_size[1]);
+    std::size_t fwd_batched_area = 0;
+    std::size_t bkw_batched_area = 0;
+    if (m_batch_size > 1) {
+        fwd_batched_area = m_forward_fft_batched.Initialize(
+            FFTType::R2R_2D, fft_size[0], fft_size[1], m_batch_size);
+        bkw_batched_area = m_backward_fft_batched.Initialize(
+            FFTType::R2R_2D, fft_size[0], fft_size[1], m_batch_size);
+    }
 
-    // Allocate work area for both FFTs
-    m_fft_work_area.resize(std::max(fwd_area, bkw_area));
+    // Allocate work area for all FFTs
+    m_fft_work_area.resize(std::max({fwd_area, bkw_area, fwd_batched_area, bkw_batched_area}));
 
     m_forward_fft.SetBuffers(m_stagingArea[0].dataPtr(), m_tmpSpectralField[0].dataPtr(),
                              m_fft_work_area.dataPtr());
     m_backward_fft.SetBuffers(m_tmpSpectralField[0].dataPtr(), m_stagingArea[0].dataPtr(),
                               m_fft_work_area.dataPtr());
+    if (m_batch_size > 1) {
+        m_forward_fft_batched.SetBuffers(m_stagingArea[0].dataPtr(),
+            m_tmpSpectralField[0].dataPtr(), m_fft_work_area.dataPtr());
+        m_backward_fft_batched.SetBuffers(m_tmpSpectralField[0].dataPtr(),
+            m_stagingArea[0].dataPtr(), m_fft_work_area.dataPtr());
+    }
 }
 
 
@@ -137,3 +154,52 @@ FFTPoissonSolverDirichletDirect::SolvePoissonEquation (amrex::MultiFab& lhs_mf)
             });
     }
 }
+
+void
+FFTPoissonSolverDirichletDirect::SolvePoissonEquationBatched (
+    amrex::Vector<amrex::MultiFab*> const& lhs_mfs)
+{
+    HIPACE_PROFILE("FFTPoissonSolverDirichletDirect::SolvePoissonEquationBatched()");
+
+    const int n_batch = m_batch_size;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(static_cast<int>(lhs_mfs.size()) == n_batch,
+        "Number of Poisson equations must be equal to the batch size of the solver");
+
+    m_forward_fft_batched.Execute();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for ( amrex::MFIter mfi(m_stagingArea, DfltMfiTlng); mfi.isValid(); ++mfi ){
+        // Solve Poisson equations in Fourier space:
+        // Multiply all components of `tmpSpectralField` by eigenvalue_matrix
+        Array3<amrex::Real> tmp_cmplx_arr = m_tmpSpectralField.array(mfi);
+        Array2<amrex::Real> eigenvalue_matrix = m_eigenvalue_matrix.array(mfi);
+
+        amrex::ParallelFor( to2D(mfi.growntilebox()), n_batch,
+            [=] AMREX_GPU_DEVICE(int i, int j, int n) noexcept {
+                tmp_cmplx_arr(i,j,n) *= eigenvalue_matrix(i,j);
+            });
+    }
+
+    m_backward_fft_batched.Execute();
+
+    for (int n=0; n<n_batch; ++n) {
+        amrex::MultiFab& lhs_mf = *lhs_mfs[n];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for ( amrex::MFIter mfi(m_stagingArea, DfltMfiTlng); mfi.isValid(); ++mfi ){
+            // Copy from the staging area to output array
+            Array3<amrex::Real> tmp_real_arr = m_stagingArea.array(mfi);
+            Array2<amrex::Real> lhs_arr = lhs_mf.array(mfi);
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(lhs_mf.size() == 1,
+                                             "Slice MFs must be defined on one box only");
+            amrex::ParallelFor( to2D(lhs_mf[mfi].box() & mfi.growntilebox()),
+                [=] AMREX_GPU_DEVICE(int i, int j) noexcept {
+                    // Copy field
+                    lhs_arr(i,j) = tmp_real_arr(i,j,n);
+                });
+        }
+    }
+}
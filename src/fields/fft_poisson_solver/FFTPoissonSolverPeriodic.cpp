@@ -16,15 +16,17 @@
 FFTPoissonSolverPeriodic::FFTPoissonSolverPeriodic (
     amrex::BoxArray const& realspace_ba,
     amrex::DistributionMapping const& dm,
-    amrex::Geometry const& gm )
+    amrex::Geometry const& gm,
+    const int batch_size )
 {
-    define(realspace_ba, dm, gm);
+    define(realspace_ba, dm, gm, batch_size);
 }
 
 void
 FFTPoissonSolverPeriodic::define ( amrex::BoxArray const& realspace_ba,
                                    amrex::DistributionMapping const& dm,
-                                   amrex::Geometry const& gm )
+                                   amrex::Geometry const& gm,
+                                   const int batch_size )
 {
     HIPACE_PROFILE("FFTPoissonSolverPeriodic::define()");
     using namespace amrex::literals;
@@ -58,8 +60,9 @@ FFTPoissonSolverPeriodic::define ( amrex::BoxArray const& realspace_ba,
 
     // Allocate temporary arrays - in real space and spectral space
     // These arrays will store the data just before/after the FFT
-    m_stagingArea = amrex::MultiFab(realspace_ba, dm, 1, 0);
-    m_tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    m_batch_size = batch_size;
+    m_stagingArea = amrex::MultiFab(realspace_ba, dm, m_batch_size, 0);
+    m_tmpSpectralField = SpectralField(spectralspace_ba, dm, m_batch_size, 0);
 
     // This must be true even for parallel FFT.
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_stagingArea.local_size() == 1,
@@ -96,14 +99,28 @@ FFTPoissonSolverPeriodic::define ( amrex::BoxArray const& realspace_ba,
     amrex::IntVect fft_size = m_stagingArea[0].box().length();
     std::size_t fwd_area = m_forward_fft.Initialize(FFTType::R2C_2D, fft_size[0], fft_size[1]);
     std::size_t bkw_area = m_backward_fft.Initialize(FFTType::C2R_2D, fft_size[0], fft_size[1]);
+    std::size_t fwd_batched_area = 0;
+    std::size_t bkw_batched_area = 0;
+    if (m_batch_size > 1) {
+        fwd_batched_area = m_forward_fft_batched.Initialize(
+            FFTType::R2C_2D, fft_size[0], fft_size[1], m_batch_size);
+        bkw_batched_area = m_backward_fft_batched.Initialize(
+            FFTType::C2R_2D, fft_size[0], fft_size[1], m_batch_size);
+    }
 
-    // Allocate work area for both FFTs
-    m_fft_work_area.resize(std::max(fwd_area, bkw_area));
+    // Allocate work area for all FFTs
+    m_fft_work_area.resize(std::max({fwd_area, bkw_area, fwd_batched_area, bkw_batched_area}));
 
     m_forward_fft.SetBuffers(m_stagingArea[0].dataPtr(), m_tmpSpectralField[0].dataPtr(),
                              m_fft_work_area.dataPtr());
     m_backward_fft.SetBuffers(m_tmpSpectralField[0].dataPtr(), m_stagingArea[0].dataPtr(),
                               m_fft_work_area.dataPtr());
+    if (m_batch_size > 1) {
+        m_forward_fft_batched.SetBuffers(m_stagingArea[0].dataPtr(),
+            m_tmpSpectralField[0].dataPtr(), m_fft_work_area.dataPtr());
+        m_backward_fft_batched.SetBuffers(m_tmpSpectralField[0].dataPtr(),
+            m_stagingArea[0].dataPtr(), m_fft_work_area.dataPtr());
+    }
 }
 
 
@@ -147,3 +164,51 @@ FFTPoissonSolverPeriodic::SolvePoissonEquation (amrex::MultiFab& lhs_mf)
 
     }
 }
+
+void
+FFTPoissonSolverPeriodic::SolvePoissonEquationBatched (
+    amrex::Vector<amrex::MultiFab*> const& lhs_mfs)
+{
+    HIPACE_PROFILE("FFTPoissonSolverPeriodic::SolvePoissonEquationBatched()");
+
+    const int n_batch = m_batch_size;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(static_cast<int>(lhs_mfs.size()) == n_batch,
+        "Number of Poisson equations must be equal to the batch size of the solver");
+
+    m_forward_fft_batched.Execute();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+    for ( amrex::MFIter mfi(m_tmpSpectralField, DfltMfiTlng); mfi.isValid(); ++mfi ){
+        // Solve Poisson equations in Fourier space:
+        // Multiply all components of `tmpSpectralField` by inv_k2
+        Array3<amrex::GpuComplex<amrex::Real>> tmp_cmplx_arr = m_tmpSpectralField.array(mfi);
+        Array2<amrex::Real> inv_k2_arr = m_inv_k2.array(mfi);
+        amrex::ParallelFor( to2D(mfi.growntilebox()), n_batch,
+            [=] AMREX_GPU_DEVICE(int i, int j, int n) noexcept {
+                tmp_cmplx_arr(i,j,n) *= -inv_k2_arr(i,j);
+            });
+    }
+
+    m_backward_fft_batched.Execute();
+
+    for (int n=0; n<n_batch; ++n) {
+        amrex::MultiFab& lhs_mf = *lhs_mfs[n];
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+        for ( amrex::MFIter mfi(m_stagingArea, DfltMfiTlng); mfi.isValid(); ++mfi ){
+            // Copy from the staging area to output array (and normalize)
+            Array3<amrex::Real> tmp_real_arr = m_stagingArea.array(mfi);
+            Array2<amrex::Real> lhs_arr = lhs_mf.array(mfi);
+            const amrex::Box fft_box = m_stagingArea[mfi].box();
+            const amrex::Real inv_N = 1./fft_box.numPts();
+            amrex::ParallelFor( to2D(mfi.growntilebox()),
+                [=] AMREX_GPU_DEVICE(int i, int j) noexcept {
+                    // Copy and normalize field
+                    lhs_arr(i,j) = inv_N*tmp_real_arr(i,j,n);
+                });
+        }
+    }
+}
@@ -62,7 +62,7 @@ void assert_cufft_status (std::string const& name, const cufftResult& status) {
     }
 }
 
-std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
+std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny, int n_batch) {
     // https://docs.nvidia.com/cuda/cufft/index.html#cufft-api-reference
     m_plan = new VendorPlan;
 
@@ -79,28 +79,28 @@ std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
             rank = 2;
             n[0] = ny;
             n[1] = nx;
-            batch = 1;
+            batch = n_batch;
             break;
         case FFTType::C2C_2D_bkw:
             transform_type = use_float ? CUFFT_C2C : CUFFT_Z2Z;
             rank = 2;
             n[0] = ny;
             n[1] = nx;
-            batch = 1;
+            batch = n_batch;
             break;
         case FFTType::C2R_2D:
             transform_type = use_float ? CUFFT_C2R : CUFFT_Z2D;
             rank = 2;
             n[0] = ny;
             n[1] = nx;
-            batch = 1;
+            batch = n_batch;
             break;
         case FFTType::R2C_2D:
             transform_type = use_float ? CUFFT_R2C : CUFFT_D2Z;
             rank = 2;
             n[0] = ny;
             n[1] = nx;
-            batch = 1;
+            batch = n_batch;
             break;
         case FFTType::R2R_2D:
             amrex::Abort("R2R FFT not supported by cufft");
@@ -109,7 +109,7 @@ std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
             transform_type = use_float ? CUFFT_C2R : CUFFT_Z2D;
             rank = 1;
             n[0] = nx;
-            batch = ny;
+            batch = static_cast<long long int>(ny) * n_batch;
             break;
     }
 
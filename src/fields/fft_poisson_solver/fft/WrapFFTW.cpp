@@ -12,8 +12,12 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "AnyFFT.H"
+#include "utils/Parser.H"
 
 #include <AMReX_Config.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
 
 #ifdef AMREX_USE_OMP
 #include <omp.h>
@@ -21,115 +25,148 @@
 
 #include <fftw3.h>
 
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #ifdef AMREX_USE_FLOAT
 static constexpr bool use_float = true;
 #else
 static constexpr bool use_float = false;
 #endif
 
+/** File to import FFTW wisdom from at setup and to export it to at cleanup */
+static std::string s_wisdom_file = "";
+/** If FFTW plans are only measured on the head rank and broadcast as wisdom to the others */
+static bool s_wisdom_broadcast = false;
+
 struct VendorPlan {
     fftwf_plan m_fftwf_plan;
     fftw_plan m_fftw_plan;
     FFTType m_type;
     int m_nx;
     int m_ny;
+    int m_batch;
 };
 
-std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
+std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny, int batch) {
     // https://www.fftw.org/fftw3_doc/FFTW-Reference.html
     m_plan = new VendorPlan;
 
     m_plan->m_type = type;
     m_plan->m_nx = nx;
     m_plan->m_ny = ny;
+    m_plan->m_batch = batch;
     // fftw doesn't allow for the manual allocation of work area, additionally the input and output
     // arrays have to be provided when planing, so we do all the work in the SetBuffers function.
     return 0;
 }
 
-void AnyFFT::SetBuffers (void* in, void* out, [[maybe_unused]] void* work_area) {
+/** \brief Create the FFTW plan. FFTW needs the input and output arrays for planning */
+static void MakePlan (VendorPlan* plan, void* in, void* out) {
+    const int nx = plan->m_nx;
+    const int ny = plan->m_ny;
+    // n is in C order, consecutive transforms of a batch are stored one after the other
+    int n[2] = {ny, nx};
     if constexpr (use_float) {
-        switch (m_plan->m_type) {
+        switch (plan->m_type) {
             case FFTType::C2C_2D_fwd:
-                m_plan->m_fftwf_plan = fftwf_plan_dft_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftwf_complex*>(in), reinterpret_cast<fftwf_complex*>(out),
+                plan->m_fftwf_plan = fftwf_plan_many_dft(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftwf_complex*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftwf_complex*>(out), nullptr, 1, nx*ny,
                     FFTW_FORWARD, FFTW_MEASURE);
                 break;
             case FFTType::C2C_2D_bkw:
-                m_plan->m_fftwf_plan = fftwf_plan_dft_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftwf_complex*>(in), reinterpret_cast<fftwf_complex*>(out),
+                plan->m_fftwf_plan = fftwf_plan_many_dft(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftwf_complex*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftwf_complex*>(out), nullptr, 1, nx*ny,
                     FFTW_BACKWARD, FFTW_MEASURE);
                 break;
             case FFTType::C2R_2D:
-                m_plan->m_fftwf_plan = fftwf_plan_dft_c2r_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftwf_complex*>(in), reinterpret_cast<float*>(out),
+                plan->m_fftwf_plan = fftwf_plan_many_dft_c2r(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftwf_complex*>(in), nullptr, 1, (nx/2+1)*ny,
+                    reinterpret_cast<float*>(out), nullptr, 1, nx*ny,
                     FFTW_MEASURE);
                 break;
             case FFTType::R2C_2D:
-                m_plan->m_fftwf_plan = fftwf_plan_dft_r2c_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<float*>(in), reinterpret_cast<fftwf_complex*>(out),
+                plan->m_fftwf_plan = fftwf_plan_many_dft_r2c(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<float*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftwf_complex*>(out), nullptr, 1, (nx/2+1)*ny,
                     FFTW_MEASURE);
                 break;
             case FFTType::R2R_2D:
-                m_plan->m_fftwf_plan = fftwf_plan_r2r_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<float*>(in), reinterpret_cast<float*>(out),
-                    FFTW_RODFT00, FFTW_RODFT00, FFTW_MEASURE);
+                {
+                    fftwf_r2r_kind kind[2] = {FFTW_RODFT00, FFTW_RODFT00};
+                    plan->m_fftwf_plan = fftwf_plan_many_r2r(
+                        2, n, plan->m_batch,
+                        reinterpret_cast<float*>(in), nullptr, 1, nx*ny,
+                        reinterpret_cast<float*>(out), nullptr, 1, nx*ny,
+                        kind, FFTW_MEASURE);
+                }
                 break;
             case FFTType::C2R_1D_batched:
                 {
-                    int n[1] = {m_plan->m_nx};
-                    m_plan->m_fftwf_plan = fftwf_plan_many_dft_c2r(
-                        1, n, m_plan->m_ny,
-                        reinterpret_cast<fftwf_complex*>(in), nullptr, 1, m_plan->m_nx/2+1,
-                        reinterpret_cast<float*>(out), nullptr, 1, m_plan->m_nx,
+                    int n_1d[1] = {nx};
+                    plan->m_fftwf_plan = fftwf_plan_many_dft_c2r(
+                        1, n_1d, ny*plan->m_batch,
+                        reinterpret_cast<fftwf_complex*>(in), nullptr, 1, nx/2+1,
+                        reinterpret_cast<float*>(out), nullptr, 1, nx,
                         FFTW_MEASURE);
                 }
                 break;
         }
     } else {
-        switch (m_plan->m_type) {
+        switch (plan->m_type) {
             case FFTType::C2C_2D_fwd:
-                m_plan->m_fftw_plan = fftw_plan_dft_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftw_complex*>(in), reinterpret_cast<fftw_complex*>(out),
+                plan->m_fftw_plan = fftw_plan_many_dft(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftw_complex*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftw_complex*>(out), nullptr, 1, nx*ny,
                     FFTW_FORWARD, FFTW_MEASURE);
                 break;
             case FFTType::C2C_2D_bkw:
-                m_plan->m_fftw_plan = fftw_plan_dft_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftw_complex*>(in), reinterpret_cast<fftw_complex*>(out),
+                plan->m_fftw_plan = fftw_plan_many_dft(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftw_complex*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftw_complex*>(out), nullptr, 1, nx*ny,
                     FFTW_BACKWARD, FFTW_MEASURE);
                 break;
             case FFTType::C2R_2D:
-                m_plan->m_fftw_plan = fftw_plan_dft_c2r_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<fftw_complex*>(in), reinterpret_cast<double*>(out),
+                plan->m_fftw_plan = fftw_plan_many_dft_c2r(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<fftw_complex*>(in), nullptr, 1, (nx/2+1)*ny,
+                    reinterpret_cast<double*>(out), nullptr, 1, nx*ny,
                     FFTW_MEASURE);
                 break;
             case FFTType::R2C_2D:
-                m_plan->m_fftw_plan = fftw_plan_dft_r2c_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<double*>(in), reinterpret_cast<fftw_complex*>(out),
+                plan->m_fftw_plan = fftw_plan_many_dft_r2c(
+                    2, n, plan->m_batch,
+                    reinterpret_cast<double*>(in), nullptr, 1, nx*ny,
+                    reinterpret_cast<fftw_complex*>(out), nullptr, 1, (nx/2+1)*ny,
                     FFTW_MEASURE);
                 break;
             case FFTType::R2R_2D:
-                m_plan->m_fftw_plan = fftw_plan_r2r_2d(
-                    m_plan->m_ny, m_plan->m_nx,
-                    reinterpret_cast<double*>(in), reinterpret_cast<double*>(out),
-                    FFTW_RODFT00, FFTW_RODFT00, FFTW_MEASURE);
+                {
+                    fftw_r2r_kind kind[2] = {FFTW_RODFT00, FFTW_RODFT00};
+                    plan->m_fftw_plan = fftw_plan_many_r2r(
+                        2, n, plan->m_batch,
+                        reinterpret_cast<double*>(in), nullptr, 1, nx*ny,
+                        reinterpret_cast<double*>(out), nullptr, 1, nx*ny,
+                        kind, FFTW_MEASURE);
+                }
                 break;
             case FFTType::C2R_1D_batched:
                 {
-                    int n[1] = {m_plan->m_nx};
-                    m_plan->m_fftw_plan = fftw_plan_many_dft_c2r(
-                        1, n, m_plan->m_ny,
-                        reinterpret_cast<fftw_complex*>(in), nullptr, 1, m_plan->m_nx/2+1,
-                        reinterpret_cast<double*>(out), nullptr, 1, m_plan->m_nx,
+                    int n_1d[1] = {nx};
+                    plan->m_fftw_plan = fftw_plan_many_dft_c2r(
+                        1, n_1d, ny*plan->m_batch,
+                        reinterpret_cast<fftw_complex*>(in), nullptr, 1, nx/2+1,
+                        reinterpret_cast<double*>(out), nullptr, 1, nx,
                         FFTW_MEASURE);
                 }
                 break;
@@ -137,6 +174,52 @@ void AnyFFT::SetBuffers (void* in, void* out, [[maybe_unused]] void* work_area)
     }
 }
 
+/** \brief Broadcast the accumulated FFTW wisdom of the head rank to all other ranks */
+static void BroadcastWisdom () {
+    char* wisdom = nullptr;
+    std::size_t wisdom_size = 0;
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        if constexpr (use_float) {
+            wisdom = fftwf_export_wisdom_to_string();
+        } else {
+            wisdom = fftw_export_wisdom_to_string();
+        }
+        wisdom_size = std::strlen(wisdom) + 1;
+    }
+    amrex::ParallelDescriptor::Bcast(&wisdom_size, 1,
+        amrex::ParallelDescriptor::IOProcessorNumber());
+    std::vector<char> buffer(wisdom_size);
+    if (amrex::ParallelDescriptor::IOProcessor()) {
+        std::memcpy(buffer.data(), wisdom, wisdom_size);
+        std::free(wisdom);
+    }
+    amrex::ParallelDescriptor::Bcast(buffer.data(), wisdom_size,
+        amrex::ParallelDescriptor::IOProcessorNumber());
+    if (!amrex::ParallelDescriptor::IOProcessor()) {
+        if constexpr (use_float) {
+            fftwf_import_wisdom_from_string(buffer.data());
+        } else {
+            fftw_import_wisdom_from_string(buffer.data());
+        }
+    }
+}
+
+void AnyFFT::SetBuffers (void* in, void* out, [[maybe_unused]] void* work_area) {
+    if (s_wisdom_broadcast && amrex::ParallelDescriptor::NProcs() > 1) {
+        // Only the head rank measures the plan, the other ranks get it as wisdom,
+        // which makes their planning with FFTW_MEASURE instantaneous.
+        if (amrex::ParallelDescriptor::IOProcessor()) {
+            MakePlan(m_plan, in, out);
+        }
+        BroadcastWisdom();
+        if (!amrex::ParallelDescriptor::IOProcessor()) {
+            MakePlan(m_plan, in, out);
+        }
+    } else {
+        MakePlan(m_plan, in, out);
+    }
+}
+
 void AnyFFT::Execute () {
     if constexpr (use_float) {
         fftwf_execute(m_plan->m_fftwf_plan);
@@ -166,9 +249,34 @@ void AnyFFT::setup () {
         fftw_plan_with_nthreads(omp_get_max_threads());
     }
 #endif
+
+    amrex::ParmParse pp("hipace");
+    queryWithParser(pp, "fftw_wisdom_file", s_wisdom_file);
+    queryWithParser(pp, "fftw_wisdom_broadcast", s_wisdom_broadcast);
+
+    if (!s_wisdom_file.empty() &&
+        (!s_wisdom_broadcast || amrex::ParallelDescriptor::IOProcessor())) {
+        // a missing wisdom file is not an error, it is created at cleanup
+        if constexpr (use_float) {
+            fftwf_import_wisdom_from_filename(s_wisdom_file.c_str());
+        } else {
+            fftw_import_wisdom_from_filename(s_wisdom_file.c_str());
+        }
+    }
 }
 
 void AnyFFT::cleanup () {
+    if (!s_wisdom_file.empty() && amrex::ParallelDescriptor::IOProcessor()) {
+        int success = 0;
+        if constexpr (use_float) {
+            success = fftwf_export_wisdom_to_filename(s_wisdom_file.c_str());
+        } else {
+            success = fftw_export_wisdom_to_filename(s_wisdom_file.c_str());
+        }
+        if (!success) {
+            amrex::Print() << "WARNING: could not write FFTW wisdom to " << s_wisdom_file << "\n";
+        }
+    }
 #if defined(AMREX_USE_OMP) && defined(HIPACE_FFTW_OMP)
     if constexpr (use_float) {
         fftwf_cleanup_threads();
@@ -68,7 +68,7 @@ void assert_rocfft_status (std::string const& name, const rocfft_status& status)
     }
 }
 
-std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
+std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny, int batch) {
     // https://rocm.docs.amd.com/projects/rocFFT/en/latest/reference/allapi.html#
     m_plan = new VendorPlan;
 
@@ -84,28 +84,28 @@ std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
             dimensions = 2;
             lengths[0] = nx;
             lengths[1] = ny;
-            number_of_transforms = 1;
+            number_of_transforms = batch;
             break;
         case FFTType::C2C_2D_bkw:
             transform_type = rocfft_transform_type_complex_inverse;
             dimensions = 2;
             lengths[0] = nx;
             lengths[1] = ny;
-            number_of_transforms = 1;
+            number_of_transforms = batch;
             break;
         case FFTType::C2R_2D:
             transform_type = rocfft_transform_type_real_inverse;
             dimensions = 2;
             lengths[0] = nx;
             lengths[1] = ny;
-            number_of_transforms = 1;
+            number_of_transforms = batch;
             break;
         case FFTType::R2C_2D:
             transform_type = rocfft_transform_type_real_forward;
             dimensions = 2;
             lengths[0] = nx;
             lengths[1] = ny;
-            number_of_transforms = 1;
+            number_of_transforms = batch;
             break;
         case FFTType::R2R_2D:
             amrex::Abort("R2R FFT not supported by rocfft");
@@ -114,7 +114,7 @@ std::size_t AnyFFT::Initialize (FFTType type, int nx, int ny) {
             transform_type = rocfft_transform_type_real_inverse;
             dimensions = 1;
             lengths[0] = nx;
-            number_of_transforms = ny;
+            number_of_transforms = static_cast<std::size_t>(ny) * batch;
             break;
     }
 
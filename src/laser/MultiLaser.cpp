@@ -18,9 +18,6 @@
 #include "utils/InsituUtil.H"
 #include "fields/fft_poisson_solver/fft/AnyFFT.H"
 #include "particles/particles_utils/ShapeFactors.H"
-#ifdef HIPACE_USE_OPENPMD
-#   include <openPMD/auxiliary/Filesystem.hpp>
-#endif
 #include <AMReX_GpuComplex.H>
 
 void
@@ -44,6 +41,11 @@ MultiLaser::ReadParameters ()
     mg_param_given += queryWithParser(pp, "MG_tolerance_abs", m_MG_tolerance_abs);
     mg_param_given += queryWithParser(pp, "MG_verbose", m_MG_verbose);
     mg_param_given += queryWithParser(pp, "MG_average_rhs", m_MG_average_rhs);
+    mg_param_given += queryWithParser(pp, "MG_use_bicgstab", m_MG_use_bicgstab);
+    mg_param_given += queryWithParser(pp, "MG_use_mixed_precision", m_MG_use_mixed_precision);
+    mg_param_given += queryWithParser(pp, "MG_initial_guess_order", m_MG_initial_guess_order);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_MG_initial_guess_order >= 0 && m_MG_initial_guess_order <= 2,
+        "lasers.MG_initial_guess_order must be 0, 1 or 2");
 
     // Raise warning if user specifies MG parameters without using the MG solver
     if (mg_param_given && (m_solver_type != "multigrid")) {
@@ -153,6 +155,10 @@ MultiLaser::InitData ()
         // need one ghost cell for 2^n-1 MG solve
         m_mg_acoeff_real.resize(amrex::grow(m_slice_box, amrex::IntVect{1, 1, 0}), 1, amrex::The_Arena());
         m_rhs_mg.resize(amrex::grow(m_slice_box, amrex::IntVect{1, 1, 0}), 2, amrex::The_Arena());
+        if (m_MG_initial_guess_order >= 2) {
+            m_mg_np1jp3.resize(m_slice_box, 2, amrex::The_Arena());
+            m_mg_np1jp3.setVal<amrex::RunOn::Device>(0.);
+        }
     }
 
     if (m_insitu_period > 0) {
@@ -213,7 +219,8 @@ MultiLaser::ShiftLaserSlices (const int islice)
 
 void
 MultiLaser::UpdateLaserAabs (const int islice, const int current_N_level, Fields& fields,
-                             amrex::Vector<amrex::Geometry> const& field_geom)
+                             amrex::Vector<amrex::Geometry> const& field_geom,
+                             const int which_slice)
 {
     if (!m_use_laser) return;
     if (!HasSlice(islice) && !HasSlice(islice + 1)) return;
@@ -224,16 +231,20 @@ MultiLaser::UpdateLaserAabs (const int islice, const int current_N_level, Fields
         // set aabs to zero if there is no laser on this slice
         // we only need to do this if the previous slice (slice + 1) had a laser
         for (int lev=0; lev<current_N_level; ++lev) {
-            fields.setVal(0, lev, WhichSlice::This, "aabs");
+            fields.setVal(0, lev, which_slice, "aabs");
         }
         return;
     }
 
+    // the next slice is still stored in the n00jp2 component of the laser
+    const int laser_comp = which_slice == WhichSlice::Next ?
+        WhichLaserSlice::n00jp2_r : WhichLaserSlice::n00j00_r;
+
     // write aabs into fields MultiFab
     for ( amrex::MFIter mfi(fields.getSlices(0), DfltMfi); mfi.isValid(); ++mfi ){
         const Array3<const amrex::Real> laser_arr = m_slices.const_array(mfi);
         const Array2<amrex::Real> field_arr =
-            fields.getSlices(0).array(mfi, Comps[WhichSlice::This]["aabs"]);
+            fields.getSlices(0).array(mfi, Comps[which_slice]["aabs"]);
 
         const amrex::Real poff_field_x = GetPosOffset(0, field_geom[0], field_geom[0].Domain());
         const amrex::Real poff_field_y = GetPosOffset(1, field_geom[0], field_geom[0].Domain());
@@ -255,8 +266,6 @@ MultiLaser::UpdateLaserAabs (const int islice, const int current_N_level, Fields
             {m_interp_order},
             mfi.growntilebox(),
             [=] AMREX_GPU_DEVICE(int i, int j, int, auto interp_order) noexcept {
-                using namespace WhichLaserSlice;
-
                 const amrex::Real x = i * dx_field + poff_field_x;
                 const amrex::Real y = j * dy_field + poff_field_y;
 
@@ -274,8 +283,8 @@ MultiLaser::UpdateLaserAabs (const int islice, const int current_N_level, Fields
                             compute_single_shape_factor<false, interp_order>(ymid, iy);
 
                         if (x_lo <= cell_x && cell_x <= x_hi && y_lo <= cell_y && cell_y <= y_hi) {
-                            aabs += shape_x*shape_y*abssq(laser_arr(cell_x, cell_y, n00j00_r),
-                                                          laser_arr(cell_x, cell_y, n00j00_i));
+                            aabs += shape_x*shape_y*abssq(laser_arr(cell_x, cell_y, laser_comp),
+                                                          laser_arr(cell_x, cell_y, laser_comp+1));
                         }
                     }
                 }
@@ -286,7 +295,7 @@ MultiLaser::UpdateLaserAabs (const int islice, const int current_N_level, Fields
 
     // interpolate aabs to higher MR levels
     for (int lev=1; lev<current_N_level; ++lev) {
-        fields.LevelUp(field_geom, lev, WhichSlice::This, "aabs");
+        fields.LevelUp(field_geom, lev, which_slice, "aabs");
     }
 }
 
@@ -418,7 +427,7 @@ MultiLaser::AdvanceSlice (const int islice, const Fields& fields, amrex::Real dt
     InterpolateChi(fields, geom_field_lev0);
 
     if (m_solver_type == "multigrid") {
-        AdvanceSliceMG(dt, step);
+        AdvanceSliceMG(dt, step, islice);
     } else if (m_solver_type == "fft") {
         AdvanceSliceFFT(dt, step);
     } else {
@@ -427,7 +436,7 @@ MultiLaser::AdvanceSlice (const int islice, const Fields& fields, amrex::Real dt
 }
 
 void
-MultiLaser::AdvanceSliceMG (amrex::Real dt, int step)
+MultiLaser::AdvanceSliceMG (amrex::Real dt, int step, int islice)
 {
 
     HIPACE_PROFILE("MultiLaser::AdvanceSliceMG()");
@@ -598,12 +607,46 @@ MultiLaser::AdvanceSliceMG (amrex::Real dt, int step)
         m_mg = std::make_unique<hpmg::MultiGrid>(m_laser_geom_3D.CellSize(0),
                                                  m_laser_geom_3D.CellSize(1),
                                                  m_slices.boxArray()[0], 2);
+        m_mg->m_use_bicgstab = m_MG_use_bicgstab;
+        m_mg->m_use_mixed_precision = m_MG_use_mixed_precision;
+    }
+
+    if (m_MG_initial_guess_order > 0) {
+        // np1j00 still contains the solution of the previous slice (np1jp1).
+        // Extrapolate the initial guess from the previous slices solved in this time step,
+        // order n needs n+1 of them.
+        const int order = std::min(m_MG_initial_guess_order,
+                                   std::max(0, m_laser_geom_3D.Domain().bigEnd(2) - islice - 1));
+        const bool store_history = m_MG_initial_guess_order >= 2;
+        amrex::Array4<amrex::Real> np1jp3_arr =
+            store_history ? m_mg_np1jp3.array() : amrex::Array4<amrex::Real>{};
+        for ( amrex::MFIter mfi(m_slices, DfltMfi); mfi.isValid(); ++mfi ){
+            Array3<amrex::Real> arr = m_slices.array(mfi);
+            amrex::ParallelFor(to2D(mfi.tilebox()), 2,
+                [=] AMREX_GPU_DEVICE(int i, int j, int n) noexcept
+                {
+                    using namespace WhichLaserSlice;
+                    const amrex::Real a1 = arr(i, j, np1jp1_r + n);
+                    const amrex::Real a2 = arr(i, j, np1jp2_r + n);
+                    if (order == 1) {
+                        arr(i, j, np1j00_r + n) = 2._rt * a1 - a2;
+                    } else if (order == 2) {
+                        arr(i, j, np1j00_r + n) = 3._rt * a1 - 3._rt * a2 + np1jp3_arr(i, j, 0, n);
+                    }
+                    if (store_history) {
+                        np1jp3_arr(i, j, 0, n) = a2;
+                    }
+                });
+        }
     }
 
     const int max_iters = 200;
     amrex::MultiFab np1j00 (m_slices, amrex::make_alias, WhichLaserSlice::np1j00_r, 2);
     m_mg->solve2(np1j00[0], m_rhs_mg, m_mg_acoeff_real, acoeff_imag_scalar,
                  m_MG_tolerance_rel, m_MG_tolerance_abs, max_iters, m_MG_verbose);
+    HipaceTracer::Counter("laser hpmg iterations", m_mg->getNumIters());
+    if (Hipace::m_verbose >= 2) amrex::Print() << "islice: " << islice << " laser hpmg iterations: "
+                                               << m_mg->getNumIters() << "\n";
 }
 
 void
@@ -1009,20 +1052,6 @@ MultiLaser::InSituWriteToFile (int step, amrex::Real time, int max_step, amrex::
     if (!utils::doDiagnostics(m_insitu_period, step, max_step, time, max_time)) return;
     HIPACE_PROFILE("MultiLaser::InSituWriteToFile()");
 
-#ifdef HIPACE_USE_OPENPMD
-    // create subdirectory
-    openPMD::auxiliary::create_directories(m_insitu_file_prefix);
-#endif
-
-    // zero pad the rank number;
-    std::string::size_type n_zeros = 4;
-    std::string rank_num = std::to_string(amrex::ParallelDescriptor::MyProc());
-    std::string pad_rank_num = std::string(n_zeros-std::min(rank_num.size(), n_zeros),'0')+rank_num;
-
-    // open file
-    std::ofstream ofs{m_insitu_file_prefix + "/reduced_laser." + pad_rank_num + ".txt",
-        std::ofstream::out | std::ofstream::app | std::ofstream::binary};
-
     const int nslices_int = m_laser_geom_3D.Domain().length(2);
     const std::size_t nslices = static_cast<std::size_t>(nslices_int);
     const int is_normalized_units = Hipace::m_normalized_units;
@@ -1053,23 +1082,7 @@ MultiLaser::InSituWriteToFile (int step, amrex::Real time, int max_step, amrex::
         }}
     };
 
-    if (ofs.tellp() == 0) {
-        // write JSON header containing a NumPy structured datatype
-        insitu_utils::write_header(all_data, ofs);
-    }
-
-    // write binary data according to datatype in header
-    insitu_utils::write_data(all_data, ofs);
-
-    // close file
-    ofs.close();
-    // assert no file errors
-#ifdef HIPACE_USE_OPENPMD
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu laser diagnostics");
-#else
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu laser diagnostics. "
-        "Maybe the specified subdirectory does not exist");
-#endif
+    Hipace::GetInstance().m_insitu_writer.Write(m_insitu_file_prefix, "laser", step, all_data);
 
     // reset arrays for insitu data
     for (auto& x : m_insitu_rdata) x = 0.;
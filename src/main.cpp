@@ -21,5 +21,6 @@ int main (int argc, char* argv[])
         hipace.InitData();
         hipace.Evolve();
     }
+    HipaceTracer::Finalize();
     amrex::Finalize();
 }
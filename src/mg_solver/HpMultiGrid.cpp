@@ -30,25 +30,25 @@ template <typename T, typename U>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
 void restrict_cc (int i, int j, int n, Array4<T> const& crse, Array4<U> const& fine)
 {
-    crse(i,j,0,n) = Real(0.25)*(fine(2*i  ,2*j  ,0,n) +
-                                fine(2*i+1,2*j  ,0,n) +
-                                fine(2*i  ,2*j+1,0,n) +
-                                fine(2*i+1,2*j+1,0,n));
+    crse(i,j,0,n) = T(0.25)*(fine(2*i  ,2*j  ,0,n) +
+                             fine(2*i+1,2*j  ,0,n) +
+                             fine(2*i  ,2*j+1,0,n) +
+                             fine(2*i+1,2*j+1,0,n));
 }
 
 template <typename T, typename U>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
 void restrict_nd (int i, int j, int n, Array4<T> const& crse, Array4<U> const& fine)
 {
-    crse(i,j,0,n) = Real(1./16.) * (fine(2*i-1,2*j-1,0,n) +
-                           Real(2.)*fine(2*i  ,2*j-1,0,n) +
-                                    fine(2*i+1,2*j-1,0,n) +
-                           Real(2.)*fine(2*i-1,2*j  ,0,n) +
-                           Real(4.)*fine(2*i  ,2*j  ,0,n) +
-                           Real(2.)*fine(2*i+1,2*j  ,0,n) +
-                                    fine(2*i-1,2*j+1,0,n) +
-                           Real(2.)*fine(2*i  ,2*j+1,0,n) +
-                                    fine(2*i+1,2*j+1,0,n));
+    crse(i,j,0,n) = T(1./16.) * (fine(2*i-1,2*j-1,0,n) +
+                           T(2.)*fine(2*i  ,2*j-1,0,n) +
+                                 fine(2*i+1,2*j-1,0,n) +
+                           T(2.)*fine(2*i-1,2*j  ,0,n) +
+                           T(4.)*fine(2*i  ,2*j  ,0,n) +
+                           T(2.)*fine(2*i+1,2*j  ,0,n) +
+                                 fine(2*i-1,2*j+1,0,n) +
+                           T(2.)*fine(2*i  ,2*j+1,0,n) +
+                                 fine(2*i+1,2*j+1,0,n));
 }
 
 template <typename T, typename U>
@@ -72,13 +72,13 @@ void interpadd_nd (int i, int j, int n, Array4<T> const& fine, Array4<U> const&
         fine(i,j,0,n) += (crse(ic  ,jc  ,0,n) +
                           crse(ic+1,jc  ,0,n) +
                           crse(ic  ,jc+1,0,n) +
-                          crse(ic+1,jc+1,0,n))*Real(0.25);
+                          crse(ic+1,jc+1,0,n))*T(0.25);
     } else if (i_is_odd) {
         fine(i,j,0,n) += (crse(ic  ,jc,0,n) +
-                          crse(ic+1,jc,0,n))*Real(0.5);
+                          crse(ic+1,jc,0,n))*T(0.5);
     } else if (j_is_odd) {
         fine(i,j,0,n) += (crse(ic,jc  ,0,n) +
-                          crse(ic,jc+1,0,n))*Real(0.5);
+                          crse(ic,jc+1,0,n))*T(0.5);
     } else {
         fine(i,j,0,n) += crse(ic,jc,0,n);
     }
@@ -108,19 +108,20 @@ void interpcpy_nd (int i, int j, int n, Array4<T> const& fine_in, Array4<U> cons
         fine_out(i,j,0,n) = fine_in(i,j,0,n) + (crse(ic  ,jc  ,0,n) +
                                                 crse(ic+1,jc  ,0,n) +
                                                 crse(ic  ,jc+1,0,n) +
-                                                crse(ic+1,jc+1,0,n))*Real(0.25);
+                                                crse(ic+1,jc+1,0,n))*T(0.25);
     } else if (i_is_odd) {
         fine_out(i,j,0,n) = fine_in(i,j,0,n) + (crse(ic  ,jc,0,n) +
-                                                crse(ic+1,jc,0,n))*Real(0.5);
+                                                crse(ic+1,jc,0,n))*T(0.5);
     } else if (j_is_odd) {
         fine_out(i,j,0,n) = fine_in(i,j,0,n) + (crse(ic,jc  ,0,n) +
-                                                crse(ic,jc+1,0,n))*Real(0.5);
+                                                crse(ic,jc+1,0,n))*T(0.5);
     } else {
         fine_out(i,j,0,n) = fine_in(i,j,0,n) +  crse(ic,jc,0,n);
     }
 }
 
-void restriction (Box const& box, Array4<Real> const& crse, Array4<Real const> const& fine,
+template <typename T>
+void restriction (Box const& box, Array4<T> const& crse, Array4<T const> const& fine,
                   int num_comps)
 {
     if (box.cellCentered()) {
@@ -137,8 +138,9 @@ void restriction (Box const& box, Array4<Real> const& crse, Array4<Real const> c
     }
 }
 
-void interpolation_outofplace (Box const& box, Array4<Real const> const& fine_in,
-                               Array4<Real const> const& crse, Array4<Real> const& fine_out,
+template <typename T>
+void interpolation_outofplace (Box const& box, Array4<T const> const& fine_in,
+                               Array4<T const> const& crse, Array4<T> const& fine_out,
                                int num_comps)
 {
     if (box.cellCentered()) {
@@ -159,102 +161,254 @@ void interpolation_outofplace (Box const& box, Array4<Real const> const& fine_in
 // Compute residual: ///////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
-Real laplacian (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
-                Array4<Real> const& phi, Real facx, Real facy)
+T laplacian (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
+             Array4<T> const& phi, T facx, T facy)
 {
-    Real lap = Real(-2.)*(facx+facy)*phi(i,j,0,n);
+    T lap = T(-2.)*(facx+facy)*phi(i,j,0,n);
     if (i == ilo) {
-        lap += facx * (Real(4./3.)*phi(i+1,j,0,n) - Real(2.)*phi(i,j,0,n));
+        lap += facx * (T(4./3.)*phi(i+1,j,0,n) - T(2.)*phi(i,j,0,n));
     } else if (i == ihi) {
-        lap += facx * (Real(4./3.)*phi(i-1,j,0,n) - Real(2.)*phi(i,j,0,n));
+        lap += facx * (T(4./3.)*phi(i-1,j,0,n) - T(2.)*phi(i,j,0,n));
     } else {
         lap += facx * (phi(i-1,j,0,n) + phi(i+1,j,0,n));
     }
     if (j == jlo) {
-        lap += facy * (Real(4./3.)*phi(i,j+1,0,n) - Real(2.)*phi(i,j,0,n));
+        lap += facy * (T(4./3.)*phi(i,j+1,0,n) - T(2.)*phi(i,j,0,n));
     } else if (j == jhi) {
-        lap += facy * (Real(4./3.)*phi(i,j-1,0,n) - Real(2.)*phi(i,j,0,n));
+        lap += facy * (T(4./3.)*phi(i,j-1,0,n) - T(2.)*phi(i,j,0,n));
     } else {
         lap += facy * (phi(i,j-1,0,n) + phi(i,j+1,0,n));
     }
     return lap;
 }
 
+template <typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
-Real residual1 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
-                Array4<Real> const& phi, Real rhs, Real acf, Real facx, Real facy)
+T residual1 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
+             Array4<T> const& phi, T rhs, T acf, T facx, T facy)
 {
-    Real lap = laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
+    T lap = laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
     return rhs + acf*phi(i,j,0,n) - lap;
 }
 
+template <typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
-Real residual2r (int i, int j, int ilo, int jlo, int ihi, int jhi,
-                 Array4<Real> const& phi, Real rhs, Real acf_r, Real acf_i,
-                 Real facx, Real facy)
+T residual2r (int i, int j, int ilo, int jlo, int ihi, int jhi,
+              Array4<T> const& phi, T rhs, T acf_r, T acf_i,
+              T facx, T facy)
 {
-    Real lap = laplacian(i,j,0,ilo,jlo,ihi,jhi,phi,facx,facy);
+    T lap = laplacian(i,j,0,ilo,jlo,ihi,jhi,phi,facx,facy);
     return rhs + acf_r*phi(i,j,0,0) - acf_i*phi(i,j,0,1) - lap;
 }
 
+template <typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
-Real residual2i (int i, int j, int ilo, int jlo, int ihi, int jhi,
-                 Array4<Real> const& phi, Real rhs, Real acf_r, Real acf_i,
-                 Real facx, Real facy)
+T residual2i (int i, int j, int ilo, int jlo, int ihi, int jhi,
+              Array4<T> const& phi, T rhs, T acf_r, T acf_i,
+              T facx, T facy)
 {
-    Real lap = laplacian(i,j,1,ilo,jlo,ihi,jhi,phi,facx,facy);
+    T lap = laplacian(i,j,1,ilo,jlo,ihi,jhi,phi,facx,facy);
     return rhs + acf_i*phi(i,j,0,0) + acf_r*phi(i,j,0,1) - lap;
 }
 
+template <typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
-Real residual3 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
-                Array4<Real> const& phi, Real rhs, Real facx, Real facy)
+T residual3 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
+             Array4<T> const& phi, T rhs, T facx, T facy)
 {
-    Real lap = laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
+    T lap = laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
     return rhs - lap;
 }
 
-#if !defined(AMREX_USE_CUDA) && !defined(AMREX_USE_HIP) && defined(AMREX_USE_GPU)
-// res = rhs - L(phi)
-void compute_residual (Box const& box, Array4<Real> const& res,
-                       Array4<Real> const& phi, Array4<Real const> const& rhs,
-                       Array4<Real const> const& acf, Real dx, Real dy,
-                       int system_type)
+// L(phi), the operator of the linear system, so that residual = rhs - L(phi)
+template <typename T>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+T operator1 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
+             Array4<T> const& phi, T acf, T facx, T facy)
+{
+    T lap = laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
+    return lap - acf*phi(i,j,0,n);
+}
+
+template <typename T>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+T operator2r (int i, int j, int ilo, int jlo, int ihi, int jhi,
+              Array4<T> const& phi, T acf_r, T acf_i, T facx, T facy)
+{
+    T lap = laplacian(i,j,0,ilo,jlo,ihi,jhi,phi,facx,facy);
+    return lap - acf_r*phi(i,j,0,0) + acf_i*phi(i,j,0,1);
+}
+
+template <typename T>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+T operator2i (int i, int j, int ilo, int jlo, int ihi, int jhi,
+              Array4<T> const& phi, T acf_r, T acf_i, T facx, T facy)
+{
+    T lap = laplacian(i,j,1,ilo,jlo,ihi,jhi,phi,facx,facy);
+    return lap - acf_i*phi(i,j,0,0) - acf_r*phi(i,j,0,1);
+}
+
+template <typename T>
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+T operator3 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
+             Array4<T> const& phi, T facx, T facy)
+{
+    return laplacian(i,j,n,ilo,jlo,ihi,jhi,phi,facx,facy);
+}
+
+// res = rhs - L(phi) if do_residual, otherwise res = L(phi) and rhs is not used
+template <bool do_residual, typename T>
+void compute_stencil (Box const& box, Array4<T> const& res,
+                      Array4<T> const& phi, Array4<T const> const& rhs,
+                      Array4<T const> const& acf, T dx, T dy,
+                      int system_type)
 {
     int const ilo = box.smallEnd(0);
     int const jlo = box.smallEnd(1);
     int const ihi = box.bigEnd(0);
     int const jhi = box.bigEnd(1);
-    Real facx = Real(1.)/(dx*dx);
-    Real facy = Real(1.)/(dy*dy);
+    T facx = T(1.)/(dx*dx);
+    T facy = T(1.)/(dy*dy);
     if (system_type == 1) {
         hpmg::ParallelFor(to2D(valid_domain_box(box)),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
         {
-            res(i,j,0,0) = residual1(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0),
-                                     acf(i,j,0), facx, facy);
-            res(i,j,0,1) = residual1(i, j, 1, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1),
-                                     acf(i,j,0), facx, facy);
+            if constexpr (do_residual) {
+                res(i,j,0,0) = residual1(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0),
+                                         acf(i,j,0), facx, facy);
+                res(i,j,0,1) = residual1(i, j, 1, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1),
+                                         acf(i,j,0), facx, facy);
+            } else {
+                res(i,j,0,0) = operator1(i, j, 0, ilo, jlo, ihi, jhi, phi, acf(i,j,0), facx, facy);
+                res(i,j,0,1) = operator1(i, j, 1, ilo, jlo, ihi, jhi, phi, acf(i,j,0), facx, facy);
+            }
         });
     } else if (system_type == 2) {
         hpmg::ParallelFor(to2D(valid_domain_box(box)),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
         {
-            res(i,j,0,0) = residual2r(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0),
-                                      acf(i,j,0,0), acf(i,j,0,1), facx, facy);
-            res(i,j,0,1) = residual2i(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1),
-                                      acf(i,j,0,0), acf(i,j,0,1), facx, facy);
+            if constexpr (do_residual) {
+                res(i,j,0,0) = residual2r(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0),
+                                          acf(i,j,0,0), acf(i,j,0,1), facx, facy);
+                res(i,j,0,1) = residual2i(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1),
+                                          acf(i,j,0,0), acf(i,j,0,1), facx, facy);
+            } else {
+                res(i,j,0,0) = operator2r(i, j, ilo, jlo, ihi, jhi, phi,
+                                          acf(i,j,0,0), acf(i,j,0,1), facx, facy);
+                res(i,j,0,1) = operator2i(i, j, ilo, jlo, ihi, jhi, phi,
+                                          acf(i,j,0,0), acf(i,j,0,1), facx, facy);
+            }
         });
     } else {
         hpmg::ParallelFor(to2D(valid_domain_box(box)),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
         {
-            res(i,j,0,0) = residual3(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), facx, facy);
+            if constexpr (do_residual) {
+                res(i,j,0,0) = residual3(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0),
+                                         facx, facy);
+            } else {
+                res(i,j,0,0) = operator3(i, j, 0, ilo, jlo, ihi, jhi, phi, facx, facy);
+            }
         });
     }
 }
-#endif
+
+// res = rhs - L(phi)
+template <typename T>
+void compute_residual (Box const& box, Array4<T> const& res,
+                       Array4<T> const& phi, Array4<T const> const& rhs,
+                       Array4<T const> const& acf, T dx, T dy,
+                       int system_type)
+{
+    compute_stencil<true>(box, res, phi, rhs, acf, dx, dy, system_type);
+}
+
+// out = L(phi)
+template <typename T>
+void compute_operator (Box const& box, Array4<T> const& out,
+                       Array4<T> const& phi, Array4<T const> const& acf, T dx, T dy,
+                       int system_type)
+{
+    compute_stencil<false>(box, out, phi, Array4<T const>{}, acf, dx, dy, system_type);
+}
+
+// sum over all components of a*b, used as the inner product of the Krylov solver
+template <typename T>
+T dot_product (Box const& box, int ncomp, BaseFab<T> const& a, BaseFab<T> const& b)
+{
+    ReduceOps<ReduceOpSum> reduce_op;
+    ReduceData<T> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    const auto& array_a = a.const_array();
+    const auto& array_b = b.const_array();
+    reduce_op.eval(valid_domain_box(box), ncomp, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int, int n) noexcept -> ReduceTuple
+        {
+            return {array_a(i,j,0,n) * array_b(i,j,0,n)};
+        });
+    return amrex::get<0>(reduce_data.value(reduce_op));
+}
+
+// maximum over all components of |a|
+template <typename T>
+T norm_inf (Box const& box, int ncomp, BaseFab<T> const& a)
+{
+    ReduceOps<ReduceOpMax> reduce_op;
+    ReduceData<T> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    const auto& array_a = a.const_array();
+    reduce_op.eval(valid_domain_box(box), ncomp, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int, int n) noexcept -> ReduceTuple
+        {
+            return {std::abs(array_a(i,j,0,n))};
+        });
+    return amrex::get<0>(reduce_data.value(reduce_op));
+}
+
+// out = a + fac_b * b + fac_c * c
+template <typename T>
+void linear_combination (Box const& box, int ncomp, BaseFab<T>& out, BaseFab<T> const& a,
+                         T fac_b, BaseFab<T> const& b, T fac_c, BaseFab<T> const& c)
+{
+    const auto& array_out = out.array();
+    const auto& array_a = a.const_array();
+    const auto& array_b = b.const_array();
+    const auto& array_c = c.const_array();
+    hpmg::ParallelFor(to2D(valid_domain_box(box)), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int n) noexcept
+        {
+            array_out(i,j,0,n) = array_a(i,j,0,n) + fac_b * array_b(i,j,0,n)
+                                                  + fac_c * array_c(i,j,0,n);
+        });
+}
+
+// out = in, converting between floating point types
+template <typename T, typename U>
+void copy_convert (Box const& box, int ncomp, BaseFab<T>& out, BaseFab<U> const& in)
+{
+    const auto& array_out = out.array();
+    const auto& array_in = in.const_array();
+    hpmg::ParallelFor(to2D(valid_domain_box(box)), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int n) noexcept
+        {
+            array_out(i,j,0,n) = static_cast<T>(array_in(i,j,0,n));
+        });
+}
+
+// out += in, converting between floating point types
+template <typename T, typename U>
+void add_convert (Box const& box, int ncomp, BaseFab<T>& out, BaseFab<U> const& in)
+{
+    const auto& array_out = out.array();
+    const auto& array_in = in.const_array();
+    hpmg::ParallelFor(to2D(valid_domain_box(box)), ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int n) noexcept
+        {
+            array_out(i,j,0,n) += static_cast<T>(array_in(i,j,0,n));
+        });
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // Gauss-Seidel update: ////////////////////////////////////////////////////////////////////////////
@@ -262,71 +416,71 @@ void compute_residual (Box const& box, Array4<Real> const& res,
 
 // is_cell_centered = true: supports both cell centered and node centered solves
 // is_cell_centered = false: only supports node centered solves, with higher performance
-template<bool is_cell_centered = true>
+template<bool is_cell_centered = true, typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
 void gs1 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
-          Array4<Real> const& phi, Real rhs, Real acf, Real facx, Real facy)
+          Array4<T> const& phi, T rhs, T acf, T facx, T facy)
 {
-    Real lap;
-    Real c0 = -(acf+Real(2.)*(facx+facy));
+    T lap;
+    T c0 = -(acf+T(2.)*(facx+facy));
     if (is_cell_centered && i == ilo) {
-        lap = facx * Real(4./3.)*phi(i+1,j,0,n);
-        c0 -= Real(2.)*facx;
+        lap = facx * T(4./3.)*phi(i+1,j,0,n);
+        c0 -= T(2.)*facx;
     } else if (is_cell_centered && i == ihi) {
-        lap = facx * Real(4./3.)*phi(i-1,j,0,n);
-        c0 -= Real(2.)*facx;
+        lap = facx * T(4./3.)*phi(i-1,j,0,n);
+        c0 -= T(2.)*facx;
     } else {
         lap = facx * (phi(i-1,j,0,n) + phi(i+1,j,0,n));
     }
     if (is_cell_centered && j == jlo) {
-        lap += facy * Real(4./3.)*phi(i,j+1,0,n);
-        c0 -= Real(2.)*facy;
+        lap += facy * T(4./3.)*phi(i,j+1,0,n);
+        c0 -= T(2.)*facy;
     } else if (is_cell_centered && j == jhi) {
-        lap += facy * Real(4./3.)*phi(i,j-1,0,n);
-        c0 -= Real(2.)*facy;
+        lap += facy * T(4./3.)*phi(i,j-1,0,n);
+        c0 -= T(2.)*facy;
     } else {
         lap += facy * (phi(i,j-1,0,n) + phi(i,j+1,0,n));
     }
-    const Real c0_inv = Real(1.) / c0;
+    const T c0_inv = T(1.) / c0;
     phi(i,j,0,n) = (rhs - lap) * c0_inv;
 }
 
 // is_cell_centered = true: supports both cell centered and node centered solves
 // is_cell_centered = false: only supports node centered solves, with higher performance
-template<bool is_cell_centered = true>
+template<bool is_cell_centered = true, typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
 void gs2 (int i, int j, int ilo, int jlo, int ihi, int jhi,
-          Array4<Real> const& phi, Real rhs_r, Real rhs_i,
-          Real ar, Real ai, Real facx, Real facy)
+          Array4<T> const& phi, T rhs_r, T rhs_i,
+          T ar, T ai, T facx, T facy)
 {
-    Real lap[2];
-    Real c0 = Real(-2.)*(facx+facy);
+    T lap[2];
+    T c0 = T(-2.)*(facx+facy);
     if (is_cell_centered && i == ilo) {
-        lap[0] = facx * Real(4./3.)*phi(i+1,j,0,0);
-        lap[1] = facx * Real(4./3.)*phi(i+1,j,0,1);
-        c0 -= Real(2.)*facx;
+        lap[0] = facx * T(4./3.)*phi(i+1,j,0,0);
+        lap[1] = facx * T(4./3.)*phi(i+1,j,0,1);
+        c0 -= T(2.)*facx;
     } else if (is_cell_centered && i == ihi) {
-        lap[0] = facx * Real(4./3.)*phi(i-1,j,0,0);
-        lap[1] = facx * Real(4./3.)*phi(i-1,j,0,1);
-        c0 -= Real(2.)*facx;
+        lap[0] = facx * T(4./3.)*phi(i-1,j,0,0);
+        lap[1] = facx * T(4./3.)*phi(i-1,j,0,1);
+        c0 -= T(2.)*facx;
     } else {
         lap[0] = facx * (phi(i-1,j,0,0) + phi(i+1,j,0,0));
         lap[1] = facx * (phi(i-1,j,0,1) + phi(i+1,j,0,1));
     }
     if (is_cell_centered && j == jlo) {
-        lap[0] += facy * Real(4./3.)*phi(i,j+1,0,0);
-        lap[1] += facy * Real(4./3.)*phi(i,j+1,0,1);
-        c0 -= Real(2.)*facy;
+        lap[0] += facy * T(4./3.)*phi(i,j+1,0,0);
+        lap[1] += facy * T(4./3.)*phi(i,j+1,0,1);
+        c0 -= T(2.)*facy;
     } else if (is_cell_centered && j == jhi) {
-        lap[0] += facy * Real(4./3.)*phi(i,j-1,0,0);
-        lap[1] += facy * Real(4./3.)*phi(i,j-1,0,1);
-        c0 -= Real(2.)*facy;
+        lap[0] += facy * T(4./3.)*phi(i,j-1,0,0);
+        lap[1] += facy * T(4./3.)*phi(i,j-1,0,1);
+        c0 -= T(2.)*facy;
     } else {
         lap[0] += facy * (phi(i,j-1,0,0) + phi(i,j+1,0,0));
         lap[1] += facy * (phi(i,j-1,0,1) + phi(i,j+1,0,1));
     }
-    Real c[2] = {c0-ar, -ai};
-    Real cmag = Real(1.)/(c[0]*c[0] + c[1]*c[1]);
+    T c[2] = {c0-ar, -ai};
+    T cmag = T(1.)/(c[0]*c[0] + c[1]*c[1]);
     c[0] *= cmag;
     c[1] *= cmag;
     phi(i,j,0,0) = (rhs_r-lap[0])*c[0] + (rhs_i-lap[1])*c[1];
@@ -335,45 +489,46 @@ void gs2 (int i, int j, int ilo, int jlo, int ihi, int jhi,
 
 // is_cell_centered = true: supports both cell centered and node centered solves
 // is_cell_centered = false: only supports node centered solves, with higher performance
-template<bool is_cell_centered = true>
+template<bool is_cell_centered = true, typename T>
 AMREX_GPU_DEVICE AMREX_FORCE_INLINE
 void gs3 (int i, int j, int n, int ilo, int jlo, int ihi, int jhi,
-          Array4<Real> const& phi, Real rhs, Real facx, Real facy)
+          Array4<T> const& phi, T rhs, T facx, T facy)
 {
-    Real lap;
-    Real c0 = -Real(2.)*(facx+facy);
+    T lap;
+    T c0 = -T(2.)*(facx+facy);
     if (is_cell_centered && i == ilo) {
-        lap = facx * Real(4./3.)*phi(i+1,j,0,n);
-        c0 -= Real(2.)*facx;
+        lap = facx * T(4./3.)*phi(i+1,j,0,n);
+        c0 -= T(2.)*facx;
     } else if (is_cell_centered && i == ihi) {
-        lap = facx * Real(4./3.)*phi(i-1,j,0,n);
-        c0 -= Real(2.)*facx;
+        lap = facx * T(4./3.)*phi(i-1,j,0,n);
+        c0 -= T(2.)*facx;
     } else {
         lap = facx * (phi(i-1,j,0,n) + phi(i+1,j,0,n));
     }
     if (is_cell_centered && j == jlo) {
-        lap += facy * Real(4./3.)*phi(i,j+1,0,n);
-        c0 -= Real(2.)*facy;
+        lap += facy * T(4./3.)*phi(i,j+1,0,n);
+        c0 -= T(2.)*facy;
     } else if (is_cell_centered && j == jhi) {
-        lap += facy * Real(4./3.)*phi(i,j-1,0,n);
-        c0 -= Real(2.)*facy;
+        lap += facy * T(4./3.)*phi(i,j-1,0,n);
+        c0 -= T(2.)*facy;
     } else {
         lap += facy * (phi(i,j-1,0,n) + phi(i,j+1,0,n));
     }
-    const Real c0_inv = Real(1.) / c0;
+    const T c0_inv = T(1.) / c0;
     phi(i,j,0,n) = (rhs - lap) * c0_inv;
 }
 
-void gsrb (int icolor, Box const& box, Array4<Real> const& phi,
-           Array4<Real const> const& rhs, Array4<Real const> const& acf,
-           Real dx, Real dy, int system_type)
+template <typename T>
+void gsrb (int icolor, Box const& box, Array4<T> const& phi,
+           Array4<T const> const& rhs, Array4<T const> const& acf,
+           T dx, T dy, int system_type)
 {
     int const ilo = box.smallEnd(0);
     int const jlo = box.smallEnd(1);
     int const ihi = box.bigEnd(0);
     int const jhi = box.bigEnd(1);
-    Real facx = Real(1.)/(dx*dx);
-    Real facy = Real(1.)/(dy*dy);
+    T facx = T(1.)/(dx*dx);
+    T facy = T(1.)/(dy*dy);
     if (system_type == 1) {
         hpmg::ParallelFor(to2D(valid_domain_box(box)),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
@@ -410,10 +565,11 @@ void gsrb (int icolor, Box const& box, Array4<Real> const& phi,
 #if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
 
 // do multiple gsrb iterations in GPU shared memory with many ghost cells
-template<int system_type, bool zero_init, bool do_compute_residual, bool is_cell_centered>
-void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const> const& rhs,
-                  Array4<Real const> const& acf, Array4<Real> const& res,
-                  Array4<Real const> const& phi_in, Real dx, Real dy)
+template<int system_type, bool zero_init, bool do_compute_residual, bool is_cell_centered,
+         typename T>
+void gsrb_shared (Box const& box, Array4<T> const& phi_out, Array4<T const> const& rhs,
+                  Array4<T const> const& acf, Array4<T> const& res,
+                  Array4<T const> const& phi_in, T dx, T dy)
 {
     constexpr int num_comps = MultiGrid::get_num_comps(system_type);
     constexpr int num_comps_acf = MultiGrid::get_num_comps_acf(system_type);
@@ -435,8 +591,8 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
     int const jlo = box.smallEnd(1);
     int const ihi = box.bigEnd(0);
     int const jhi = box.bigEnd(1);
-    Real facx = Real(1.)/(dx*dx);
-    Real facy = Real(1.)/(dy*dy);
+    T facx = T(1.)/(dx*dx);
+    T facy = T(1.)/(dy*dy);
 
     // box for the bounds of the ParallelFor loop this kernel replaces
     const Box loop_box = valid_domain_box(box);
@@ -452,7 +608,7 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
         [=] AMREX_GPU_DEVICE() noexcept
         {
             // allocate static shared memory
-            __shared__ Real phi_ptr[num_cells_in_tile];
+            __shared__ T phi_ptr[num_cells_in_tile];
 
             std::uint64_t remainder = 0;
             const int iblock_y = num_blocks_divmod.divmod(remainder, blockIdx.x);
@@ -465,13 +621,13 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
             const int tile_end_y = tile_begin_y + tilesize_array_y;
 
             // make Array4 reference shared memory tile
-            Array4<Real> phi_shared(phi_ptr, {tile_begin_x, tile_begin_y, 0},
-                                             {tile_end_x, tile_end_y, 1}, num_comps);
+            Array4<T> phi_shared(phi_ptr, {tile_begin_x, tile_begin_y, 0},
+                                          {tile_end_x, tile_end_y, 1}, num_comps);
 
             if (zero_init) {
                 // initialize shared memory to zero
                 for (int s = threadIdx.x; s < num_cells_in_tile; s+=blockDim.x) {
-                    phi_ptr[s] = Real(0.);
+                    phi_ptr[s] = T(0.);
                 }
             } else {
                 // initialize shared memory to phi_in inside the domain, outside zero
@@ -487,7 +643,7 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
                         }
                     } else {
                         for (int n=0; n<num_comps; ++n) {
-                            phi_shared(sx, sy, 0, n) = Real(0.);
+                            phi_shared(sx, sy, 0, n) = T(0.);
                         }
                     }
                 }
@@ -500,8 +656,8 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
             const int i = tile_begin_x + 1 + ithread_x;
             const int j = tile_begin_y + 1 + ithread_y;
 
-            amrex::GpuArray<Real, num_comps> rhs_num[2] = {{}, {}};
-            amrex::GpuArray<Real, num_comps_acf> acf_num[2] = {{}, {}};
+            amrex::GpuArray<T, num_comps> rhs_num[2] = {{}, {}};
+            amrex::GpuArray<T, num_comps_acf> acf_num[2] = {{}, {}};
 
             for (int nj=0; nj<=1; ++nj) {
                 if (ilo_loop <= i && i <= ihi_loop &&
@@ -591,11 +747,35 @@ void gsrb_shared (Box const& box, Array4<Real> const& phi_out, Array4<Real const
 
 #elif !defined(AMREX_USE_GPU)
 
+// Gauss-Seidel update of a single cell for the given system type
+template<int system_type, bool is_cell_centered, typename T>
+AMREX_FORCE_INLINE
+void gs_cell (int i, int j, int ilo, int jlo, int ihi, int jhi, Array4<T> const& phi,
+              Array4<T const> const& rhs, Array4<T const> const& acf,
+              T facx, T facy)
+{
+    if constexpr (system_type == 1) {
+        gs1<is_cell_centered>(i, j, 0, ilo, jlo, ihi, jhi, phi,
+            rhs(i, j, 0, 0), acf(i, j, 0, 0), facx, facy);
+        gs1<is_cell_centered>(i, j, 1, ilo, jlo, ihi, jhi, phi,
+            rhs(i, j, 0, 1), acf(i, j, 0, 0), facx, facy);
+    } else if constexpr (system_type == 2) {
+        gs2<is_cell_centered>(i, j, ilo, jlo, ihi, jhi, phi,
+            rhs(i, j, 0, 0), rhs(i, j, 0, 1),
+            acf(i, j, 0, 0), acf(i, j, 0, 1), facx, facy);
+    } else {
+        amrex::ignore_unused(acf);
+        gs3<is_cell_centered>(i, j, 0, ilo, jlo, ihi, jhi, phi,
+            rhs(i, j, 0, 0), facx, facy);
+    }
+}
+
 // do multiple gsrb iterations in CPU cached memory with many ghost cells
-template<int system_type, bool zero_init, bool do_compute_residual, bool is_cell_centered>
-void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const> const& rhs,
-                  Array4<Real const> const& acf, Array4<Real> const& res,
-                  Array4<Real const> const& phi_in, Real dx, Real dy)
+template<int system_type, bool zero_init, bool do_compute_residual, bool is_cell_centered,
+         typename T>
+void gsrb_cached (Box const& box, Array4<T> const& phi_out, Array4<T const> const& rhs,
+                  Array4<T const> const& acf, Array4<T> const& res,
+                  Array4<T const> const& phi_in, T dx, T dy)
 {
     constexpr int num_comps = MultiGrid::get_num_comps(system_type);
     constexpr int tilesize_x = 64;
@@ -614,8 +794,8 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
     int const jlo = box.smallEnd(1);
     int const ihi = box.bigEnd(0);
     int const jhi = box.bigEnd(1);
-    const Real facx = Real(1.)/(dx*dx);
-    const Real facy = Real(1.)/(dy*dy);
+    const T facx = T(1.)/(dx*dx);
+    const T facy = T(1.)/(dy*dy);
 
     // box for the bounds of the ParallelFor loop this kernel replaces
     const Box loop_box = valid_domain_box(box);
@@ -633,7 +813,7 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
         for (int iblock_x=0; iblock_x<num_blocks_x; ++iblock_x) {
 
             // allocate cached memory
-            Real phi_ptr[tilesize_array_x * tilesize_array_y * num_comps];
+            T phi_ptr[tilesize_array_x * tilesize_array_y * num_comps];
 
             const int tile_begin_x = iblock_x * final_tilesize_x - edge_offset - 1 + ilo_loop;
             const int tile_begin_y = iblock_y * final_tilesize_y - edge_offset - 1 + jlo_loop;
@@ -642,13 +822,13 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
             const int tile_end_y = tile_begin_y + tilesize_array_y;
 
             // make Array4 reference cached memory tile
-            Array4<Real> phi_cached(phi_ptr, {tile_begin_x, tile_begin_y, 0},
-                                             {tile_end_x, tile_end_y, 1}, num_comps);
+            Array4<T> phi_cached(phi_ptr, {tile_begin_x, tile_begin_y, 0},
+                                          {tile_end_x, tile_end_y, 1}, num_comps);
 
             if  (zero_init) {
                 // initialize cached memory to zero
                 for (int s = 0; s < tilesize_array_x * tilesize_array_y * num_comps; ++s) {
-                    phi_ptr[s] = Real(0.);
+                    phi_ptr[s] = T(0.);
                 }
             } else {
                 // initialize cached memory to phi_in inside the domain, outside zero
@@ -661,7 +841,7 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
                             }
                         } else {
                             for (int n=0; n<num_comps; ++n) {
-                                phi_cached(i, j, 0, n) = Real(0.);
+                                phi_cached(i, j, 0, n) = T(0.);
                             }
                         }
                     }
@@ -676,21 +856,37 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
                 const int j_start = std::max(tile_begin_y + 1, jlo_loop);
                 const int j_end = std::min(tile_end_y - 1, jhi_loop + 1);
                 for (int j = j_start; j < j_end; ++j) {
-                    int shift = (i_start + j + icolor) & 1;
-                    for (int i = i_start + shift; i < i_end; i+=2) {
-                        if (system_type == 1) {
-                            gs1<is_cell_centered>(i, j, 0, ilo, jlo, ihi, jhi, phi_cached,
-                                rhs(i, j, 0, 0), acf(i, j, 0, 0), facx, facy);
-                            gs1<is_cell_centered>(i, j, 1, ilo, jlo, ihi, jhi, phi_cached,
-                                rhs(i, j, 0, 1), acf(i, j, 0, 0), facx, facy);
-                        } else if (system_type == 2) {
-                            gs2<is_cell_centered>(i, j, ilo, jlo, ihi, jhi, phi_cached,
-                                rhs(i, j, 0, 0), rhs(i, j, 0, 1),
-                                acf(i, j, 0, 0), acf(i, j, 0, 1), facx, facy);
-                        } else if (system_type == 3) {
-                            gs3<is_cell_centered>(i, j, 0, ilo, jlo, ihi, jhi, phi_cached,
-                                rhs(i, j, 0, 0), facx, facy);
+                    const int i_first = i_start + ((i_start + j + icolor) & 1);
+                    if (is_cell_centered && (j == jlo || j == jhi)) {
+                        // boundary row, uses the one-sided stencil everywhere
+                        for (int i = i_first; i < i_end; i+=2) {
+                            gs_cell<system_type, true>(i, j, ilo, jlo, ihi, jhi, phi_cached,
+                                                       rhs, acf, facx, facy);
+                        }
+                        continue;
+                    }
+                    // Cells of one color only depend on cells of the other color, so the
+                    // interior of the row can be vectorized using the branch-free stencil.
+                    // Only the first and last cell of a cell centered row need special care.
+                    int i_simd_begin = i_first;
+                    int i_simd_end = i_end;
+                    if (is_cell_centered) {
+                        if (i_simd_begin == ilo) {
+                            gs_cell<system_type, true>(ilo, j, ilo, jlo, ihi, jhi, phi_cached,
+                                                       rhs, acf, facx, facy);
+                            i_simd_begin += 2;
                         }
+                        i_simd_end = std::min(i_end, ihi);
+                    }
+                    AMREX_PRAGMA_SIMD
+                    for (int i = i_simd_begin; i < i_simd_end; i+=2) {
+                        gs_cell<system_type, false>(i, j, ilo, jlo, ihi, jhi, phi_cached,
+                                                    rhs, acf, facx, facy);
+                    }
+                    if (is_cell_centered && i_end > ihi && ihi >= i_simd_begin &&
+                        (ihi - i_first) % 2 == 0) {
+                        gs_cell<system_type, true>(ihi, j, ilo, jlo, ihi, jhi, phi_cached,
+                                                   rhs, acf, facx, facy);
                     }
                 }
             }
@@ -700,6 +896,7 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
             const int j_start = std::max(tile_begin_y + 1 + edge_offset, jlo_loop);
             const int j_end = std::min(tile_end_y - 1 - edge_offset, jhi_loop + 1);
             for (int j = j_start; j < j_end; ++j) {
+                AMREX_PRAGMA_SIMD
                 for (int i = i_start; i < i_end; ++i) {
                     // store results in main memory but only in the shrunken box
                     // where the result is correct
@@ -741,14 +938,14 @@ void gsrb_cached (Box const& box, Array4<Real> const& phi_out, Array4<Real const
 
 #endif
 
-template<bool zero_init, bool do_compute_residual>
+template<bool zero_init, bool do_compute_residual, typename T>
 void gsrb_4_residual (int system_type, Box const& box,
-                      Array4<Real> const& phi_out,
-                      Array4<Real const> const& rhs,
-                      Array4<Real const> const& acf,
-                      Array4<Real> const& res,
-                      Array4<Real const> const& phi_in,
-                      Real dx, Real dy)
+                      Array4<T> const& phi_out,
+                      Array4<T const> const& rhs,
+                      Array4<T const> const& acf,
+                      Array4<T> const& res,
+                      Array4<T const> const& phi_in,
+                      T dx, T dy)
 {
     // This function performs the main computation for the multigrid solver.
     // For CUDA / HIP it is implemented to use a single GPU kernel with shared memory
@@ -814,9 +1011,9 @@ void gsrb_4_residual (int system_type, Box const& box,
 
 #else
     if (zero_init) {
-        Real * pcor_out = phi_out.dataPtr();
+        T * pcor_out = phi_out.dataPtr();
         hpmg::ParallelFor(box.numPts()*MultiGrid::get_num_comps(system_type),
-            [=] AMREX_GPU_DEVICE (Long i) noexcept { pcor_out[i] = Real(0.); });
+            [=] AMREX_GPU_DEVICE (Long i) noexcept { pcor_out[i] = T(0.); });
     } else {
         const amrex::Box valid_domain = valid_domain_box(box);
         hpmg::ParallelFor(to2D(box), MultiGrid::get_num_comps(system_type),
@@ -824,7 +1021,7 @@ void gsrb_4_residual (int system_type, Box const& box,
                 if (valid_domain.contains(i,j,0)) {
                     phi_out(i,j,0,n) = phi_in(i,j,0,n);
                 } else {
-                    phi_out(i,j,0,n) = Real(0.);
+                    phi_out(i,j,0,n) = T(0.);
                 }
             });
     }
@@ -851,10 +1048,10 @@ void gsrb_4_residual (int system_type, Box const& box,
 #define HPMG_SYNCTHREADS __syncthreads()
 #endif
 
-template <int NS, int system_type, typename FGS, typename FRES>
-void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
-                      Array4<Real> const* res, Array4<Real> const* cor,
-                      Array4<Real> const* rescor, int nlevs, int corner_offset,
+template <int NS, int system_type, typename T, typename FGS, typename FRES>
+void bottomsolve_gpu (T dx0, T dy0, Array4<T> const* acf,
+                      Array4<T> const* res, Array4<T> const* cor,
+                      Array4<T> const* rescor, int nlevs, int corner_offset,
                       FGS&& fgs, FRES&& fres)
 {
     // This function performs all the operations of a vcycle in a single GPU kernel by
@@ -872,8 +1069,8 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
     [=] AMREX_GPU_DEVICE () noexcept
 #endif
     {
-        Real facx = Real(1.)/(dx0*dx0);
-        Real facy = Real(1.)/(dy0*dy0);
+        T facx = T(1.)/(dx0*dx0);
+        T facy = T(1.)/(dy0*dy0);
         int lenx = cor[0].end.x - cor[0].begin.x - 2*corner_offset;
         int leny = cor[0].end.y - cor[0].begin.y - 2*corner_offset;
         int ncells = lenx*leny;
@@ -891,10 +1088,10 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
             // set phi to zero
             if (icell < ncells) {
                 if (system_type == 1 || system_type == 2) {
-                    cor[ilev](i,j,0,0) = Real(0.);
-                    cor[ilev](i,j,0,1) = Real(0.);
+                    cor[ilev](i,j,0,0) = T(0.);
+                    cor[ilev](i,j,0,1) = T(0.);
                 } else {
-                    cor[ilev](i,j,0,0) = Real(0.);
+                    cor[ilev](i,j,0,0) = T(0.);
                 }
             }
             HPMG_SYNCTHREADS;
@@ -952,8 +1149,8 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
             }
             HPMG_SYNCTHREADS;
 
-            facx *= Real(0.25);
-            facy *= Real(0.25);
+            facx *= T(0.25);
+            facy *= T(0.25);
         }
 
         // bottom
@@ -962,10 +1159,10 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
             const int ilev = nlevs-1;
             if (icell < ncells) {
                 if (system_type == 1 || system_type == 2) {
-                    cor[ilev](i,j,0,0) = Real(0.);
-                    cor[ilev](i,j,0,1) = Real(0.);
+                    cor[ilev](i,j,0,0) = T(0.);
+                    cor[ilev](i,j,0,1) = T(0.);
                 } else {
-                    cor[ilev](i,j,0,0) = Real(0.);
+                    cor[ilev](i,j,0,0) = T(0.);
                 }
             }
             HPMG_SYNCTHREADS;
@@ -990,8 +1187,8 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
             lenx = cor[ilev].end.x - cor[ilev].begin.x - 2*corner_offset;
             leny = cor[ilev].end.y - cor[ilev].begin.y - 2*corner_offset;
             ncells = lenx*leny;
-            facx *= Real(4.);
-            facy *= Real(4.);
+            facx *= T(4.);
+            facy *= T(4.);
 
             if (icell < ncells) {
                 j = icell /   lenx;
@@ -1040,8 +1237,9 @@ void bottomsolve_gpu (Real dx0, Real dy0, Array4<Real> const* acf,
 // Initialization: /////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-MultiGrid::MultiGrid (Real dx, Real dy, Box a_domain, int a_system_type)
-    : m_system_type(a_system_type), m_dx(dx), m_dy(dy)
+template <typename T>
+MultiGridT<T>::MultiGridT (T dx, T dy, Box a_domain, int a_system_type)
+    : m_system_type(a_system_type), m_input_domain(a_domain), m_dx(dx), m_dy(dy)
 {
     m_num_comps = get_num_comps(m_system_type);
     m_num_comps_acf = get_num_comps_acf(m_system_type);
@@ -1166,15 +1364,16 @@ MultiGrid::MultiGrid (Real dx, Real dy, Box a_domain, int a_system_type)
 // Solve start functions: //////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
 void
-MultiGrid::solve1 (FArrayBox& a_sol, FArrayBox const& a_rhs, FArrayBox const& a_acf,
-                   Real const tol_rel, Real const tol_abs, int const nummaxiter,
-                   int const verbose)
+MultiGridT<T>::solve1 (BaseFab<T>& a_sol, BaseFab<T> const& a_rhs, BaseFab<T> const& a_acf,
+                       T const tol_rel, T const tol_abs, int const nummaxiter,
+                       int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve1()");
     AMREX_ALWAYS_ASSERT(m_system_type == 1);
 
-    FArrayBox afab(center_box(a_acf.box(), m_domain.front()), 1, a_acf.dataPtr());
+    BaseFab<T> afab(center_box(a_acf.box(), m_domain.front()), 1, a_acf.dataPtr());
 
     auto const& array_m_acf = m_acf[0].array();
     auto const& array_a_acf = afab.const_array();
@@ -1189,11 +1388,12 @@ MultiGrid::solve1 (FArrayBox& a_sol, FArrayBox const& a_rhs, FArrayBox const& a_
     solve_doit(a_sol, a_rhs, tol_rel, tol_abs, nummaxiter, verbose);
 }
 
+template <typename T>
 void
-MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
-                   amrex::Real const acoef_real, amrex::Real const acoef_imag,
-                   amrex::Real const tol_rel, amrex::Real const tol_abs,
-                   int const nummaxiter, int const verbose)
+MultiGridT<T>::solve2 (BaseFab<T>& sol, BaseFab<T> const& rhs,
+                       T const acoef_real, T const acoef_imag,
+                       T const tol_rel, T const tol_abs,
+                       int const nummaxiter, int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve2()");
     AMREX_ALWAYS_ASSERT(m_system_type == 2);
@@ -1212,18 +1412,19 @@ MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
     solve_doit(sol, rhs, tol_rel, tol_abs, nummaxiter, verbose);
 }
 
+template <typename T>
 void
-MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
-                   amrex::Real const acoef_real, amrex::FArrayBox const& acoef_imag,
-                   amrex::Real const tol_rel, amrex::Real const tol_abs,
-                   int const nummaxiter, int const verbose)
+MultiGridT<T>::solve2 (BaseFab<T>& sol, BaseFab<T> const& rhs,
+                       T const acoef_real, BaseFab<T> const& acoef_imag,
+                       T const tol_rel, T const tol_abs,
+                       int const nummaxiter, int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve2()");
     AMREX_ALWAYS_ASSERT(m_system_type == 2);
 
     auto const& array_m_acf = m_acf[0].array();
 
-    amrex::FArrayBox ifab(center_box(acoef_imag.box(), m_domain.front()), 1, acoef_imag.dataPtr());
+    BaseFab<T> ifab(center_box(acoef_imag.box(), m_domain.front()), 1, acoef_imag.dataPtr());
     auto const& ai = ifab.const_array();
     hpmg::ParallelFor(to2D(m_acf[0].box()),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
@@ -1237,18 +1438,19 @@ MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
     solve_doit(sol, rhs, tol_rel, tol_abs, nummaxiter, verbose);
 }
 
+template <typename T>
 void
-MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
-                   amrex::FArrayBox const& acoef_real, amrex::Real const acoef_imag,
-                   amrex::Real const tol_rel, amrex::Real const tol_abs,
-                   int const nummaxiter, int const verbose)
+MultiGridT<T>::solve2 (BaseFab<T>& sol, BaseFab<T> const& rhs,
+                       BaseFab<T> const& acoef_real, T const acoef_imag,
+                       T const tol_rel, T const tol_abs,
+                       int const nummaxiter, int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve2()");
     AMREX_ALWAYS_ASSERT(m_system_type == 2);
 
     auto const& array_m_acf = m_acf[0].array();
 
-    amrex::FArrayBox rfab(center_box(acoef_real.box(), m_domain.front()), 1, acoef_real.dataPtr());
+    BaseFab<T> rfab(center_box(acoef_real.box(), m_domain.front()), 1, acoef_real.dataPtr());
     auto const& ar = rfab.const_array();
     hpmg::ParallelFor(to2D(m_acf[0].box()),
         [=] AMREX_GPU_DEVICE (int i, int j) noexcept
@@ -1262,19 +1464,20 @@ MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
     solve_doit(sol, rhs, tol_rel, tol_abs, nummaxiter, verbose);
 }
 
+template <typename T>
 void
-MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
-                   amrex::FArrayBox const& acoef_real, amrex::FArrayBox const& acoef_imag,
-                   amrex::Real const tol_rel, amrex::Real const tol_abs,
-                   int const nummaxiter, int const verbose)
+MultiGridT<T>::solve2 (BaseFab<T>& sol, BaseFab<T> const& rhs,
+                       BaseFab<T> const& acoef_real, BaseFab<T> const& acoef_imag,
+                       T const tol_rel, T const tol_abs,
+                       int const nummaxiter, int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve2()");
     AMREX_ALWAYS_ASSERT(m_system_type == 2);
 
     auto const& array_m_acf = m_acf[0].array();
 
-    amrex::FArrayBox rfab(center_box(acoef_real.box(), m_domain.front()), 1, acoef_real.dataPtr());
-    amrex::FArrayBox ifab(center_box(acoef_imag.box(), m_domain.front()), 1, acoef_imag.dataPtr());
+    BaseFab<T> rfab(center_box(acoef_real.box(), m_domain.front()), 1, acoef_real.dataPtr());
+    BaseFab<T> ifab(center_box(acoef_imag.box(), m_domain.front()), 1, acoef_imag.dataPtr());
     auto const& ar = rfab.const_array();
     auto const& ai = ifab.const_array();
     hpmg::ParallelFor(to2D(m_acf[0].box()),
@@ -1289,10 +1492,11 @@ MultiGrid::solve2 (amrex::FArrayBox& sol, amrex::FArrayBox const& rhs,
     solve_doit(sol, rhs, tol_rel, tol_abs, nummaxiter, verbose);
 }
 
+template <typename T>
 void
-MultiGrid::solve3 (FArrayBox& a_sol, FArrayBox const& a_rhs,
-                   Real const tol_rel, Real const tol_abs, int const nummaxiter,
-                   int const verbose)
+MultiGridT<T>::solve3 (BaseFab<T>& a_sol, BaseFab<T> const& a_rhs,
+                       T const tol_rel, T const tol_abs, int const nummaxiter,
+                       int const verbose)
 {
     HIPACE_PROFILE("hpmg::MultiGrid::solve3()");
     AMREX_ALWAYS_ASSERT(m_system_type == 3);
@@ -1304,15 +1508,16 @@ MultiGrid::solve3 (FArrayBox& a_sol, FArrayBox const& a_rhs,
 // Main solve functions: ///////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename T>
 void
-MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
-                       Real const tol_rel, Real const tol_abs, int const nummaxiter,
-                       int const verbose)
+MultiGridT<T>::solve_doit (BaseFab<T>& a_sol, BaseFab<T> const& a_rhs,
+                           T const tol_rel, T const tol_abs, int const nummaxiter,
+                           int const verbose)
 {
     AMREX_ALWAYS_ASSERT(a_sol.nComp() >= m_num_comps && a_rhs.nComp() >= m_num_comps);
 
-    m_sol = FArrayBox(center_box(a_sol.box(), m_domain.front()), m_num_comps, a_sol.dataPtr());
-    m_rhs = FArrayBox(center_box(a_rhs.box(), m_domain.front()), m_num_comps, a_rhs.dataPtr());
+    m_sol = BaseFab<T>(center_box(a_sol.box(), m_domain.front()), m_num_comps, a_sol.dataPtr());
+    m_rhs = BaseFab<T>(center_box(a_rhs.box(), m_domain.front()), m_num_comps, a_rhs.dataPtr());
 
     // sol: initial solution guess
     // rhs: right hand side of differential equation to solve
@@ -1324,13 +1529,13 @@ MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
     // cor = gsrb(gsrb(gsrb(gsrb(sol))))
     // rescor = rhs - L(cor)
     gsrb_4_residual<false, true>(m_system_type, m_domain[0], m_cor[0].array(), m_rhs.const_array(),
-        m_acf[0].const_array(), m_rescor[0].array(), m_sol.array(), m_dx, m_dy);
+        m_acf[0].const_array(), m_rescor[0].array(), m_sol.const_array(), m_dx, m_dy);
 
     // Reduction on the right-hand side and residual to get convergence criteria
-    Real resnorm0, rhsnorm0;
+    T resnorm0, rhsnorm0;
     {
         ReduceOps<ReduceOpMax,ReduceOpMax> reduce_op;
-        ReduceData<Real,Real> reduce_data(reduce_op);
+        ReduceData<T,T> reduce_data(reduce_op);
         using ReduceTuple = typename decltype(reduce_data)::Type;
         const auto& array_res = m_rescor[0].const_array();
         const auto& array_rhs = m_rhs.const_array();
@@ -1349,7 +1554,7 @@ MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
                        << "hpmg: Initial residual (resid0) = " << resnorm0 << "\n";
     }
 
-    Real max_norm;
+    T max_norm;
     std::string norm_name;
     if (rhsnorm0 >= resnorm0) {
         norm_name = "bnorm";
@@ -1358,31 +1563,52 @@ MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
         norm_name = "resid0";
         max_norm = resnorm0;
     }
-    const Real res_target = std::max(tol_abs, std::max(tol_rel,Real(1.e-16))*max_norm);
+    const T res_target = std::max(tol_abs, std::max(tol_rel,T(1.e-16))*max_norm);
+
+    m_num_iters = 0;
+
+    if (use_mixed_precision() && resnorm0 > res_target) {
+        if (!m_mg_float) {
+            m_mg_float = std::make_unique<MultiGridT<float>>(static_cast<float>(m_dx),
+                static_cast<float>(m_dy), m_input_domain, m_system_type);
+            m_mixed_rhs.resize(m_domain[0], m_num_comps);
+            m_mixed_rhs.template setVal<RunOn::Device>(0);
+        }
+        // the coefficient is only needed in single precision on the coarser levels
+        copy_convert(m_domain[0], m_num_comps_acf, m_mg_float->m_acf[0], m_acf[0]);
+        m_mg_float->average_down_acoef();
+    }
 
     if (resnorm0 <= res_target) {
         if (verbose >= 1) {
             amrex::Print() << "hpmg: No iterations needed\n";
         }
+    } else if (m_use_bicgstab) {
+        solve_bicgstab(res_target, max_norm, norm_name, nummaxiter, verbose);
     } else {
-        Real norminf = 0.;
+        T norminf = 0.;
         bool converged = true;
 
         for (int iter = 0; iter < nummaxiter; ++iter) {
 
             converged = false;
+            m_num_iters = iter + 1;
 
             // do one vcycle iteration with the fist 4 Gauss-Seidel iterations omitted
             // from the beginning and instead done after the vcycle to also get the residual
-            vcycle();
+            if (use_mixed_precision()) {
+                vcycle_mixed_precision();
+            } else {
+                vcycle();
+            }
 
             // check the residual for convergence
-            Real const* pres0 = m_rescor[0].dataPtr();
-            norminf = Reduce::Max<Real>(m_domain[0].numPts()*m_num_comps,
-                                        [=] AMREX_GPU_DEVICE (Long i) -> Real
-                                        {
-                                            return std::abs(pres0[i]);
-                                        });
+            T const* pres0 = m_rescor[0].dataPtr();
+            norminf = Reduce::Max<T>(m_domain[0].numPts()*m_num_comps,
+                                     [=] AMREX_GPU_DEVICE (Long i) -> T
+                                     {
+                                         return std::abs(pres0[i]);
+                                     });
             if (verbose >= 2) {
                 amrex::Print() << "hpmg: Iteration " << std::setw(3) << iter+1 << " resid/"
                                << norm_name << " = " << norminf/max_norm << "\n";
@@ -1396,7 +1622,7 @@ MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
                                    << norminf << ", " << norminf/max_norm << "\n";
                 }
                 break;
-            } else if (norminf > Real(1.e20)*max_norm) {
+            } else if (norminf > T(1.e20)*max_norm) {
                 if (verbose > 0) {
                     amrex::Print() << "hpmg: Failing to converge after " << iter+1 << " iterations."
                                    << " resid, resid/" << norm_name << " = "
@@ -1426,11 +1652,231 @@ MultiGrid::solve_doit (FArrayBox& a_sol, FArrayBox const& a_rhs,
     });
 }
 
+template <typename T>
 void
-MultiGrid::vcycle ()
+MultiGridT<T>::solve_bicgstab (T const res_target, T const max_norm,
+                               std::string const& norm_name, int const nummaxiter,
+                               int const verbose)
+{
+    HIPACE_PROFILE("hpmg::MultiGrid::solve_bicgstab()");
+
+    // Right-preconditioned BiCGStab for A x = rhs using one V-cycle as preconditioner.
+    // All vectors use real inner products over all components, so Type II systems are
+    // solved in their equivalent real formulation with twice the number of unknowns.
+    // On entry, cor[0] and rescor[0] hold the smoothed initial guess and its residual.
+
+    Box const& domain = m_domain[0];
+
+    if (m_krylov.empty()) {
+        m_krylov.reserve(krylov_nvecs);
+        for (int ivec = 0; ivec < krylov_nvecs; ++ivec) {
+            m_krylov.emplace_back(domain, m_num_comps);
+            // boundary nodes of the nodal domain have to stay zero
+            m_krylov[ivec].template setVal<RunOn::Device>(0);
+        }
+    }
+
+    // aliases to the user arrays, m_sol and m_rhs are used by the preconditioner
+    BaseFab<T> sol_user(m_sol.box(), m_num_comps, m_sol.dataPtr());
+    BaseFab<T> rhs_user(m_rhs.box(), m_num_comps, m_rhs.dataPtr());
+
+    BaseFab<T>& x = m_krylov[krylov_x];
+    BaseFab<T>& r = m_krylov[krylov_r];
+    BaseFab<T>& rhat = m_krylov[krylov_rhat];
+    BaseFab<T>& p = m_krylov[krylov_p];
+    BaseFab<T>& v = m_krylov[krylov_v];
+    BaseFab<T>& phat = m_krylov[krylov_phat];
+    BaseFab<T>& shat = m_krylov[krylov_shat];
+    BaseFab<T>& t = m_krylov[krylov_t];
+
+    // x = cor, r = rescor, rhat = r
+    {
+        auto const& array_x = x.array();
+        auto const& array_r = r.array();
+        auto const& array_rhat = rhat.array();
+        auto const& array_cor = m_cor[0].const_array();
+        auto const& array_rescor = m_rescor[0].const_array();
+        hpmg::ParallelFor(to2D(valid_domain_box(domain)), m_num_comps,
+            [=] AMREX_GPU_DEVICE (int i, int j, int n) noexcept
+            {
+                array_x(i,j,0,n) = array_cor(i,j,0,n);
+                array_r(i,j,0,n) = array_rescor(i,j,0,n);
+                array_rhat(i,j,0,n) = array_rescor(i,j,0,n);
+            });
+    }
+
+    T rho_old = 1.;
+    T alpha = 1.;
+    T omega = 1.;
+    T norminf = 0.;
+    bool converged = false;
+    bool restart = true;
+
+    m_num_iters = 0;
+    while (m_num_iters < nummaxiter) {
+
+        T rho = dot_product(domain, m_num_comps, rhat, r);
+        if (rho == 0.) {
+            // breakdown, restart with the current residual as shadow residual
+            rhat.template copy<RunOn::Device>(r);
+            rho = dot_product(domain, m_num_comps, rhat, r);
+            restart = true;
+        }
+
+        if (restart) {
+            // p = r
+            linear_combination(domain, m_num_comps, p, r, T(0.), r, T(0.), r);
+            restart = false;
+        } else {
+            // p = r + beta * (p - omega * v)
+            T const beta = (rho/rho_old) * (alpha/omega);
+            linear_combination(domain, m_num_comps, p, r, beta, p, -beta*omega, v);
+        }
+
+        // phat = M^-1 p, v = A phat
+        precondition(phat, p);
+        apply_operator(v, phat);
+
+        T const rhat_v = dot_product(domain, m_num_comps, rhat, v);
+        if (rhat_v == 0.) {
+            restart = true;
+            rhat.template copy<RunOn::Device>(r);
+            continue;
+        }
+        alpha = rho / rhat_v;
+
+        // s = r - alpha * v, stored in r
+        linear_combination(domain, m_num_comps, r, r, -alpha, v, T(0.), v);
+
+        norminf = norm_inf(domain, m_num_comps, r);
+        if (norminf <= res_target) {
+            // x = x + alpha * phat
+            linear_combination(domain, m_num_comps, x, x, alpha, phat, T(0.), phat);
+            converged = true;
+        } else {
+            // shat = M^-1 s, t = A shat
+            precondition(shat, r);
+            apply_operator(t, shat);
+
+            T const t_t = dot_product(domain, m_num_comps, t, t);
+            omega = (t_t > 0.) ? dot_product(domain, m_num_comps, t, r) / t_t : 0.;
+
+            // x = x + alpha * phat + omega * shat
+            linear_combination(domain, m_num_comps, x, x, alpha, phat, omega, shat);
+            // r = s - omega * t
+            linear_combination(domain, m_num_comps, r, r, -omega, t, T(0.), t);
+
+            norminf = norm_inf(domain, m_num_comps, r);
+            converged = (norminf <= res_target);
+            if (omega == 0.) {
+                restart = true;
+                rhat.template copy<RunOn::Device>(r);
+            }
+        }
+
+        if (verbose >= 2) {
+            amrex::Print() << "hpmg: BiCGStab V-cycle " << std::setw(3) << m_num_iters
+                           << " resid/" << norm_name << " = " << norminf/max_norm << "\n";
+        }
+
+        if (converged) {
+            if (verbose >= 1) {
+                amrex::Print() << "hpmg: BiCGStab final V-cycle " << m_num_iters
+                               << " resid, resid/" << norm_name << " = "
+                               << norminf << ", " << norminf/max_norm << "\n";
+            }
+            break;
+        } else if (!(norminf <= T(1.e20)*max_norm)) {
+            amrex::Print() << "hpmg: BiCGStab failing to converge after " << m_num_iters
+                           << " V-cycles. resid, resid/" << norm_name << " = "
+                           << norminf << ", " << norminf/max_norm << "\n";
+            amrex::Abort("hpmg failing so lets stop here");
+        }
+
+        rho_old = rho;
+    }
+
+    if (!converged) {
+        // unlike the plain V-cycle iteration, the current iterate is kept
+        amrex::Print() << "hpmg: WARNING BiCGStab did not converge after " << m_num_iters
+                       << " V-cycles. resid, resid/" << norm_name << " = "
+                       << norminf << ", " << norminf/max_norm << "\n";
+    }
+
+    // restore the aliases and store the result in cor for the final copy into sol
+    m_sol = BaseFab<T>(sol_user.box(), m_num_comps, sol_user.dataPtr());
+    m_rhs = BaseFab<T>(rhs_user.box(), m_num_comps, rhs_user.dataPtr());
+    m_cor[0].template copy<RunOn::Device>(x);
+}
+
+template <typename T>
+void
+MultiGridT<T>::precondition (BaseFab<T>& out, BaseFab<T> const& in)
+{
+    // out = vcycle(0) applied to the right hand side in
+    if (use_mixed_precision()) {
+        copy_convert(m_domain[0], m_num_comps, m_mixed_rhs, in);
+        m_mg_float->vcycle_zero_guess(m_mixed_rhs);
+        copy_convert(m_domain[0], m_num_comps, out, m_mg_float->m_cor[0]);
+    } else {
+        vcycle_zero_guess(in);
+        out.template copy<RunOn::Device>(m_cor[0]);
+    }
+    ++m_num_iters;
+}
+
+template <typename T>
+void
+MultiGridT<T>::vcycle_zero_guess (BaseFab<T> const& rhs)
+{
+    if (!m_precond_sol.isAllocated()) {
+        m_precond_sol.resize(m_domain[0], m_num_comps);
+        m_precond_sol.template setVal<RunOn::Device>(0);
+    }
+
+    // m_sol and m_rhs have to be restored by the caller if they are needed afterwards
+    m_rhs = BaseFab<T>(m_domain[0], m_num_comps, rhs.dataPtr());
+    m_sol = BaseFab<T>(m_domain[0], m_num_comps, m_precond_sol.dataPtr());
+
+    // cor = gsrb(gsrb(gsrb(gsrb(0))))
+    // rescor = rhs - L(cor)
+    gsrb_4_residual<true, true>(m_system_type, m_domain[0], m_cor[0].array(),
+        m_rhs.const_array(), m_acf[0].const_array(), m_rescor[0].array(), {}, m_dx, m_dy);
+
+    vcycle();
+}
+
+template <typename T>
+void
+MultiGridT<T>::vcycle_mixed_precision ()
+{
+    // single precision V-cycle for the correction of the current residual
+    copy_convert(m_domain[0], m_num_comps, m_mixed_rhs, m_rescor[0]);
+    m_mg_float->vcycle_zero_guess(m_mixed_rhs);
+
+    // cor = cor + vcycle(rescor)
+    add_convert(m_domain[0], m_num_comps, m_cor[0], m_mg_float->m_cor[0]);
+
+    // rescor = rhs - L(cor)
+    compute_residual(m_domain[0], m_rescor[0].array(), m_cor[0].array(), m_rhs.const_array(),
+                     m_acf[0].const_array(), m_dx, m_dy, m_system_type);
+}
+
+template <typename T>
+void
+MultiGridT<T>::apply_operator (BaseFab<T>& out, BaseFab<T>& in)
+{
+    // out = L(in)
+    compute_operator(m_domain[0], out.array(), in.array(), m_acf[0].const_array(),
+                     m_dx, m_dy, m_system_type);
+}
+
+template <typename T>
+void
+MultiGridT<T>::vcycle ()
 {
 #if defined(AMREX_USE_CUDA)
-    std::pair<const amrex::Real*, const amrex::Real*> key {
+    std::pair<const T*, const T*> key {
         m_sol.array().dataPtr(),
         m_rhs.const_array().dataPtr()
     };
@@ -1441,9 +1887,9 @@ MultiGrid::vcycle ()
 
     for (int ilev = 0; ilev < m_single_block_level_begin; ++ilev) {
 
-        Real fac = static_cast<Real>(1 << ilev);
-        Real dx = m_dx * fac;
-        Real dy = m_dy * fac;
+        T fac = static_cast<T>(1 << ilev);
+        T dx = m_dx * fac;
+        T dy = m_dy * fac;
 
         if (ilev > 0) {
             // cor and residual on ilev 0 are already calculated before the vcycle is started
@@ -1469,9 +1915,9 @@ MultiGrid::vcycle ()
 
     for (int ilev = m_single_block_level_begin-1; ilev >= 0; --ilev) {
 
-        Real fac = static_cast<Real>(1 << ilev);
-        Real dx = m_dx * fac;
-        Real dy = m_dy * fac;
+        T fac = static_cast<T>(1 << ilev);
+        T dx = m_dx * fac;
+        T dy = m_dy * fac;
 
         // interpolate solution from previous level to phi
 
@@ -1500,7 +1946,7 @@ MultiGrid::vcycle ()
     // rescor = rhs - L(cor)
     gsrb_4_residual<false, true>(
         m_system_type, m_domain[0], m_cor[0].array(), m_rhs.const_array(),
-        m_acf[0].const_array(), m_rescor[0].array(), m_sol.array(), m_dx, m_dy);
+        m_acf[0].const_array(), m_rescor[0].array(), m_sol.const_array(), m_dx, m_dy);
 
 #if defined(AMREX_USE_CUDA)
         cudaStreamEndCapture(Gpu::gpuStream(), &m_cuda_graph_vcycle[key].first);
@@ -1511,13 +1957,14 @@ MultiGrid::vcycle ()
 #endif
 }
 
+template <typename T>
 void
-MultiGrid::bottomsolve ()
+MultiGridT<T>::bottomsolve ()
 {
     constexpr int nsweeps = 16;
-    Real fac = static_cast<Real>(1 << m_single_block_level_begin);
-    Real dx0 = m_dx * fac;
-    Real dy0 = m_dy * fac;
+    T fac = static_cast<T>(1 << m_single_block_level_begin);
+    T dx0 = m_dx * fac;
+    T dy0 = m_dy * fac;
 #if defined(AMREX_USE_GPU)
     if (m_use_single_block_kernel) {
         int nlevs = m_num_single_block_levels;
@@ -1526,54 +1973,54 @@ MultiGrid::bottomsolve ()
         if (m_system_type == 1) {
             bottomsolve_gpu<nsweeps,1>(dx0, dy0, m_acf_a, m_res_a, m_cor_a, m_rescor_a, nlevs, corner_offset,
                 [] AMREX_GPU_DEVICE (int i, int j, int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const& acf, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const& acf, T facx, T facy)
                 {
-                    Real a = acf(i,j,0);
+                    T a = acf(i,j,0);
                     gs1(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), a, facx, facy);
                     gs1(i, j, 1, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1), a, facx, facy);
                 },
-                [] AMREX_GPU_DEVICE (int i, int j, Array4<Real> const& res,
+                [] AMREX_GPU_DEVICE (int i, int j, Array4<T> const& res,
                                       int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const& acf, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const& acf, T facx, T facy)
                 {
-                    Real a = acf(i,j,0);
+                    T a = acf(i,j,0);
                     res(i,j,0,0) = residual1(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), a, facx, facy);
                     res(i,j,0,1) = residual1(i, j, 1, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1), a, facx, facy);
                 });
         } else if (m_system_type == 2) {
             bottomsolve_gpu<nsweeps,2>(dx0, dy0, m_acf_a, m_res_a, m_cor_a, m_rescor_a, nlevs, corner_offset,
                 [] AMREX_GPU_DEVICE (int i, int j, int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const& acf, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const& acf, T facx, T facy)
                 {
-                    Real ar = acf(i,j,0,0);
-                    Real ai = acf(i,j,0,1);
+                    T ar = acf(i,j,0,0);
+                    T ai = acf(i,j,0,1);
                     gs2(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), rhs(i,j,0,1), ar, ai, facx, facy);
                 },
-                [] AMREX_GPU_DEVICE (int i, int j, Array4<Real> const& res,
+                [] AMREX_GPU_DEVICE (int i, int j, Array4<T> const& res,
                                       int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const& acf, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const& acf, T facx, T facy)
                 {
-                    Real ar = acf(i,j,0,0);
-                    Real ai = acf(i,j,0,1);
+                    T ar = acf(i,j,0,0);
+                    T ai = acf(i,j,0,1);
                     res(i,j,0,0) = residual2r(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), ar, ai, facx, facy);
                     res(i,j,0,1) = residual2i(i, j, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,1), ar, ai, facx, facy);
                 });
         } else {
             bottomsolve_gpu<nsweeps,3>(dx0, dy0, m_acf_a, m_res_a, m_cor_a, m_rescor_a, nlevs, corner_offset,
                 [] AMREX_GPU_DEVICE (int i, int j, int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const&, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const&, T facx, T facy)
                 {
                     gs3(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), facx, facy);
                 },
-                [] AMREX_GPU_DEVICE (int i, int j, Array4<Real> const& res,
+                [] AMREX_GPU_DEVICE (int i, int j, Array4<T> const& res,
                                       int ilo, int jlo, int ihi, int jhi,
-                                      Array4<Real> const& phi, Array4<Real> const& rhs,
-                                      Array4<Real> const&, Real facx, Real facy)
+                                      Array4<T> const& phi, Array4<T> const& rhs,
+                                      Array4<T> const&, T facx, T facy)
                 {
                     res(i,j,0,0) = residual3(i, j, 0, ilo, jlo, ihi, jhi, phi, rhs(i,j,0,0), facx, facy);
                 });
@@ -1582,7 +2029,7 @@ MultiGrid::bottomsolve ()
 #endif
     {
         const int ilev = m_single_block_level_begin;
-        m_cor[ilev].setVal<amrex::RunOn::Device>(Real(0.));
+        m_cor[ilev].template setVal<amrex::RunOn::Device>(T(0.));
         // Use numsweeps equal to the box length rounded up to an even number for large boxes
         int numsweeps = std::max(nsweeps, (m_cor[ilev].box().length().max() + 1) / 2 * 2);
         for (int is = 0; is < numsweeps; ++is) {
@@ -1599,8 +2046,8 @@ MultiGrid::bottomsolve ()
 
 #if defined(AMREX_USE_GPU)
 namespace {
-    template <typename F>
-    void avgdown_acf (Array4<Real> const* acf, int ncomp, int nlevels, F&& f)
+    template <typename T, typename F>
+    void avgdown_acf (Array4<T> const* acf, int ncomp, int nlevels, F&& f)
     {
 #if defined(AMREX_USE_DPCPP)
         amrex::launch(1, 1024, Gpu::gpuStream(),
@@ -1637,8 +2084,9 @@ namespace {
 }
 #endif
 
+template <typename T>
 void
-MultiGrid::average_down_acoef ()
+MultiGridT<T>::average_down_acoef ()
 {
 #if defined(AMREX_USE_CUDA)
     if (!m_cuda_graph_acf_created) {
@@ -1667,21 +2115,21 @@ MultiGrid::average_down_acoef ()
     if (m_num_single_block_levels > 1) {
         if (m_domain[0].cellCentered()) {
             avgdown_acf(m_acf_a, m_num_comps_acf, m_num_single_block_levels,
-                        [] AMREX_GPU_DEVICE (int i, int j, int n, Array4<Real> const& crse,
-                                             Array4<Real> const& fine) noexcept
+                        [] AMREX_GPU_DEVICE (int i, int j, int n, Array4<T> const& crse,
+                                             Array4<T> const& fine) noexcept
                         {
                             restrict_cc(i,j,n,crse,fine);
                         });
         } else {
             avgdown_acf(m_acf_a, m_num_comps_acf, m_num_single_block_levels,
-                        [] AMREX_GPU_DEVICE (int i, int j, int n, Array4<Real> const& crse,
-                                             Array4<Real> const& fine) noexcept
+                        [] AMREX_GPU_DEVICE (int i, int j, int n, Array4<T> const& crse,
+                                             Array4<T> const& fine) noexcept
                         {
                             if (i == crse.begin.x ||
                                 j == crse.begin.y ||
                                 i == crse.end.x-1 ||
                                 j == crse.end.y-1) {
-                                crse(i,j,0,n) = Real(0.);
+                                crse(i,j,0,n) = T(0.);
                             } else {
                                 restrict_nd(i,j,n,crse,fine);
                             }
@@ -1699,7 +2147,8 @@ MultiGrid::average_down_acoef ()
 #endif
 }
 
-MultiGrid::~MultiGrid ()
+template <typename T>
+MultiGridT<T>::~MultiGridT ()
 {
 #if defined(AMREX_USE_CUDA)
     if (m_cuda_graph_acf_created) {
@@ -1713,4 +2162,9 @@ MultiGrid::~MultiGrid ()
 #endif
 }
 
+template class MultiGridT<float>;
+#if !defined(AMREX_USE_FLOAT)
+template class MultiGridT<double>;
+#endif
+
 }
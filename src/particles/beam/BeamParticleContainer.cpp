@@ -12,9 +12,7 @@
 #include "Hipace.H"
 #include "utils/HipaceProfilerWrapper.H"
 #include "utils/InsituUtil.H"
-#ifdef HIPACE_USE_OPENPMD
-#   include <openPMD/auxiliary/Filesystem.hpp>
-#endif
+#include "utils/ScratchArena.H"
 
 namespace
 {
@@ -35,6 +33,26 @@ namespace
             mass = phys_const.m_e;
         }
     }
+
+    /** \brief Apply the permutation perm to the first np elements of data
+     *
+     * \param[in,out] data particle component to permute
+     * \param[in] tmp temporary buffer of size np
+     * \param[in] perm permutation, new index to old index
+     * \param[in] np number of particles to permute
+     */
+    template<class T>
+    void PermuteParticleData (T* data, T* tmp, const unsigned int* perm, int np)
+    {
+        amrex::ParallelFor(np,
+            [=] AMREX_GPU_DEVICE (int i) {
+                tmp[i] = data[perm[i]];
+            });
+        amrex::ParallelFor(np,
+            [=] AMREX_GPU_DEVICE (int i) {
+                data[i] = tmp[i];
+            });
+    }
 }
 
 
@@ -61,8 +79,22 @@ BeamParticleContainer::ReadParameters ()
     queryWithParserAlt(pp, "insitu_period", m_insitu_period, pp_alt);
     queryWithParserAlt(pp, "insitu_file_prefix", m_insitu_file_prefix, pp_alt);
     queryWithParserAlt(pp, "insitu_radius", m_insitu_radius, pp_alt);
+    m_insitu_histograms.ReadParameters(m_name, "beams");
     queryWithParser(pp, "n_subcycles", m_n_subcycles);
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE( m_n_subcycles >= 1, "n_subcycles must be >= 1");
+    queryWithParser(pp, "adaptive_subcycling", m_adaptive_subcycling);
+    if (m_adaptive_subcycling) {
+        m_n_subcycles_max = m_n_subcycles;
+        queryWithParser(pp, "n_subcycles_min", m_n_subcycles_min);
+        queryWithParser(pp, "n_subcycles_max", m_n_subcycles_max);
+        queryWithParser(pp, "subcycling_max_phase", m_subcycling_max_phase);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            1 <= m_n_subcycles_min && m_n_subcycles_min <= m_n_subcycles_max,
+            "Must have 1 <= n_subcycles_min <= n_subcycles_max");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_subcycling_max_phase > 0,
+            "subcycling_max_phase must be > 0");
+        m_subcycling_stats.resize(2, 0);
+    }
     queryWithParser(pp, "do_salame", m_do_salame);
     queryWithParserAlt(pp, "reorder_period", m_reorder_period, pp_alt);
     amrex::Array<int, 2> idx_array
@@ -86,6 +118,9 @@ BeamParticleContainer::ReadParameters ()
         {"x", "y", "z", "t"});
     m_external_fields[5] = makeFunctionWithParser<4>(field_str[2], m_external_fields_parser[5],
         {"x", "y", "z", "t"});
+    if (m_use_external_fields) {
+        m_external_fields_table.ReadParameters(pp, pp_alt);
+    }
     if (m_injection_type == "fixed_ppc" || m_injection_type == "from_file"){
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE( m_duz_per_uz0_dzeta == 0.,
         "Tilted beams and correlated energy spreads are only implemented for fixed weight beams");
@@ -102,6 +137,11 @@ BeamParticleContainer::ReadParameters ()
         soa.GetIntData()[icomp].setArena(
             m_initialize_on_cpu ? amrex::The_Pinned_Arena() : amrex::The_Arena());
     }
+    queryWithParserAlt(pp, "init_prefetch_slices", m_init_prefetch_slices, pp_alt);
+#ifdef AMREX_USE_GPU
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_init_prefetch_slices == 0 || m_initialize_on_cpu,
+        "<beam name>.init_prefetch_slices requires <beam name>.initialize_on_cpu = 1");
+#endif
     queryWithParserAlt(pp, "do_spin_tracking", m_do_spin_tracking, pp_alt);
     if (m_do_spin_tracking) {
         getWithParserAlt(pp, "initial_spin", m_initial_spin, pp_alt);
@@ -256,6 +296,7 @@ BeamParticleContainer::InitData (const amrex::Geometry& geom)
                                                         m_file_coordinates_xyz, pp_alt);
         queryWithParserAlt(pp, "plasma_density", m_plasma_density, pp_alt);
         queryWithParserAlt(pp, "iteration", m_num_iteration, pp_alt);
+        queryWithParserAlt(pp, "file_chunk_size", m_file_chunk_size, pp_alt);
         bool species_specified = queryWithParser(pp, "openPMD_species_name", m_species_name);
         if(!species_specified) {
             m_species_name = m_name;
@@ -357,6 +398,49 @@ BeamParticleContainer::initializeSlice (int slice, int which_slice) {
         InitBeamFixedWeightSlice(slice, which_slice);
     } else if (m_injection_type == "fixed_weight_pdf") {
         InitBeamFixedWeightPDFSlice(slice, which_slice);
+    } else if (m_init_prefetch_slices > 0) {
+        HIPACE_PROFILE("BeamParticleContainer::initializeSlice()");
+        const int num_particles = m_init_sorter.m_box_counts_cpu[slice];
+
+        resize(which_slice, num_particles, 0);
+
+        // slices are initialized in decreasing order, so this only blocks for the first slice
+        PrefetchInitSlice(slice);
+        InitPrefetchSlot& slot = m_init_prefetch[slice % m_init_prefetch_slices];
+        if (slot.slice != slice) {
+            // the slot holds a different slice, discard it
+            slot.gathered.get();
+            slot.slice = -1;
+            PrefetchInitSlice(slice);
+        }
+        slot.gathered.get();
+
+        auto& soa_init = slot.data.GetStructOfArrays();
+        auto& soa = getBeamSlice(which_slice).GetStructOfArrays();
+        for (int rcomp = 0; rcomp < BeamIdx::real_nattribs_in_buffer; ++rcomp) {
+            amrex::Gpu::htod_memcpy_async(soa.GetRealData(rcomp).dataPtr(),
+                soa_init.GetRealData(rcomp).dataPtr(), num_particles*sizeof(amrex::ParticleReal));
+        }
+        amrex::Gpu::htod_memcpy_async(soa.GetIdCPUData().dataPtr(),
+            soa_init.GetIdCPUData().dataPtr(), num_particles*sizeof(uint64_t));
+
+        auto ptd = getBeamSlice(which_slice).getParticleTileData();
+        amrex::ParallelFor(num_particles,
+            [=] AMREX_GPU_DEVICE (const int ip) {
+                ptd.idata(BeamIdx::nsubcycles)[ip] = 0;
+                ptd.idata(BeamIdx::mr_level)[ip] = 0;
+                ptd.idata(BeamIdx::nsubcycles_total)[ip] = 0;
+            }
+        );
+
+        // the slot can only be reused once the copy is finished
+        amrex::Gpu::streamSynchronize();
+        slot.slice = -1;
+
+        // gather the next slices while the current slices are computed
+        for (int i = 1; i <= m_init_prefetch_slices; ++i) {
+            PrefetchInitSlice(slice - i);
+        }
     } else {
         HIPACE_PROFILE("BeamParticleContainer::initializeSlice()");
         const int num_particles = m_init_sorter.m_box_counts_cpu[slice];
@@ -366,12 +450,13 @@ BeamParticleContainer::initializeSlice (int slice, int which_slice) {
         auto ptd_init = getBeamInitSlice().getParticleTileData();
         auto ptd = getBeamSlice(which_slice).getParticleTileData();
 
-        const int slice_offset = m_init_sorter.m_box_offsets_cpu[slice];
+        // 64 bit offsets, the full beam can have more than 2^31 particles
+        const amrex::Long slice_offset = m_init_sorter.m_box_offsets_cpu[slice];
         const auto permutations = m_init_sorter.m_box_permutations.dataPtr();
 
         amrex::ParallelFor(num_particles,
             [=] AMREX_GPU_DEVICE (const int ip) {
-                const int idx_src = permutations[slice_offset + ip];
+                const auto idx_src = permutations[slice_offset + ip];
                 ptd.rdata(BeamIdx::x)[ip] = ptd_init.rdata(BeamIdx::x)[idx_src];
                 ptd.rdata(BeamIdx::y)[ip] = ptd_init.rdata(BeamIdx::y)[idx_src];
                 ptd.rdata(BeamIdx::z)[ip] = ptd_init.rdata(BeamIdx::z)[idx_src];
@@ -383,6 +468,7 @@ BeamParticleContainer::initializeSlice (int slice, int which_slice) {
                 ptd.idcpu(ip) = ptd_init.idcpu(idx_src);
                 ptd.idata(BeamIdx::nsubcycles)[ip] = 0;
                 ptd.idata(BeamIdx::mr_level)[ip] = 0;
+                ptd.idata(BeamIdx::nsubcycles_total)[ip] = 0;
             }
         );
     }
@@ -403,6 +489,53 @@ BeamParticleContainer::initializeSlice (int slice, int which_slice) {
     }
 }
 
+void
+BeamParticleContainer::PrefetchInitSlice (int slice) {
+    if (slice < 0) return;
+
+    if (m_init_prefetch.size() == 0) {
+        m_init_prefetch.resize(m_init_prefetch_slices);
+        for (auto& slot : m_init_prefetch) {
+            auto& soa = slot.data.GetStructOfArrays();
+            soa.GetIdCPUData().setArena(amrex::The_Pinned_Arena());
+            for (int rcomp = 0; rcomp < soa.NumRealComps(); ++rcomp) {
+                soa.GetRealData()[rcomp].setArena(amrex::The_Pinned_Arena());
+            }
+            for (int icomp = 0; icomp < soa.NumIntComps(); ++icomp) {
+                soa.GetIntData()[icomp].setArena(amrex::The_Pinned_Arena());
+            }
+        }
+    }
+
+    InitPrefetchSlot& slot = m_init_prefetch[slice % m_init_prefetch_slices];
+    if (slot.slice != -1) {
+        // already prefetched or the slot is still in use
+        return;
+    }
+
+    const int num_particles = m_init_sorter.m_box_counts_cpu[slice];
+    const amrex::Long slice_offset = m_init_sorter.m_box_offsets_cpu[slice];
+
+    // allocate on the main thread, the copy is done in the background
+    slot.slice = slice;
+    slot.data.resize(num_particles);
+
+    auto ptd_init = getBeamInitSlice().getParticleTileData();
+    auto ptd = slot.data.getParticleTileData();
+    const auto permutations = m_init_sorter.m_box_permutations.dataPtr();
+
+    slot.gathered = std::async(std::launch::async,
+        [=] () {
+            for (int ip = 0; ip < num_particles; ++ip) {
+                const auto idx_src = permutations[slice_offset + ip];
+                for (int rcomp = 0; rcomp < BeamIdx::real_nattribs_in_buffer; ++rcomp) {
+                    ptd.rdata(rcomp)[ip] = ptd_init.rdata(rcomp)[idx_src];
+                }
+                ptd.idcpu(ip) = ptd_init.idcpu(idx_src);
+            }
+        });
+}
+
 void
 BeamParticleContainer::resize (int which_slice, int num_particles, int num_slipped_particles) {
     HIPACE_PROFILE("BeamParticleContainer::resize()");
@@ -428,46 +561,29 @@ BeamParticleContainer::ReorderParticles (int beam_slice, int step, amrex::Geomet
         const unsigned int* permutations = perm.dataPtr();
         auto& soa = ptile.GetStructOfArrays();
 
+        // Gather every component into a temporary buffer of the scratch arena and copy it
+        // back. Slipped particles are not permuted, so only np elements are copied.
         {
-            typename BeamTile::SoA::IdCPU tmp_idcpu(np_total);
-
-            auto src = soa.GetIdCPUData().data();
-            uint64_t* dst = tmp_idcpu.data();
-            amrex::ParallelFor(np_total,
-                [=] AMREX_GPU_DEVICE (int i) {
-                    dst[i] = i < np ? src[permutations[i]] : src[i];
-                });
-
-            amrex::Gpu::streamSynchronize();
-            soa.GetIdCPUData().swap(tmp_idcpu);
+            ScratchScope scratch_scope;
+            auto tmp_idcpu = MakeScratchVector<uint64_t>(np);
+            PermuteParticleData(soa.GetIdCPUData().data(), tmp_idcpu.data(), permutations, np);
         }
 
-        { // Create a scope for the temporary vector below
-            BeamTile::RealVector tmp_real(np_total);
+        {
+            ScratchScope scratch_scope;
+            auto tmp_real = MakeScratchVector<amrex::ParticleReal>(np);
             for (int comp = 0; comp < soa.NumRealComps(); ++comp) {
-                auto src = soa.GetRealData(comp).data();
-                amrex::ParticleReal* dst = tmp_real.data();
-                amrex::ParallelFor(np_total,
-                    [=] AMREX_GPU_DEVICE (int i) {
-                        dst[i] = i < np ? src[permutations[i]] : src[i];
-                    });
-
-                amrex::Gpu::streamSynchronize();
-                soa.GetRealData(comp).swap(tmp_real);
+                PermuteParticleData(soa.GetRealData(comp).data(), tmp_real.data(),
+                                    permutations, np);
             }
         }
 
-        BeamTile::IntVector tmp_int(np_total);
-        for (int comp = 0; comp < soa.NumIntComps(); ++comp) {
-            auto src = soa.GetIntData(comp).data();
-            int* dst = tmp_int.data();
-            amrex::ParallelFor(np_total,
-                [=] AMREX_GPU_DEVICE (int i) {
-                    dst[i] = i < np ? src[permutations[i]] : src[i];
-                });
-
-            amrex::Gpu::streamSynchronize();
-            soa.GetIntData(comp).swap(tmp_int);
+        {
+            ScratchScope scratch_scope;
+            auto tmp_int = MakeScratchVector<int>(np);
+            for (int comp = 0; comp < soa.NumIntComps(); ++comp) {
+                PermuteParticleData(soa.GetIntData(comp).data(), tmp_int.data(), permutations, np);
+            }
         }
     }
 }
@@ -486,6 +602,7 @@ BeamParticleContainer::InSituComputeDiags (int islice)
     const PhysConst phys_const = get_phys_const();
     const amrex::Real clight_inv = 1.0_rt/phys_const.c;
     const auto ptd = getBeamSlice(WhichBeamSlice::This).getParticleTileData();
+    const auto histograms = m_insitu_histograms.getDeviceData();
 
     amrex::TypeMultiplier<amrex::ReduceOps, amrex::ReduceOpSum[m_insitu_nrp + m_insitu_nip]> reduce_op;
     amrex::TypeMultiplier<amrex::ReduceData, amrex::Real[m_insitu_nrp], int[m_insitu_nip]> reduce_data(reduce_op);
@@ -508,6 +625,11 @@ BeamParticleContainer::InSituComputeDiags (int islice)
                 return amrex::IdentityTuple(ReduceTuple{}, reduce_op);
             }
             const amrex::Real gamma = std::sqrt(1.0_rt + ux*ux + uy*uy + uz*uz);
+            if (histograms.m_nhist > 0) {
+                // binned in the same pass, see HistogramQuantity for the order
+                const amrex::Real q[HistogramQuantity::nquantities] = {x, y, z, ux, uy, uz, gamma};
+                histograms.add(q, w);
+            }
             return {            // Tuple contains:
                 w,              // 0    sum(w)
                 w*x,            // 1    [x]
@@ -597,20 +719,6 @@ BeamParticleContainer::InSituWriteToFile (int step, amrex::Real time, const amre
 {
     HIPACE_PROFILE("BeamParticleContainer::InSituWriteToFile()");
 
-#ifdef HIPACE_USE_OPENPMD
-    // create subdirectory
-    openPMD::auxiliary::create_directories(m_insitu_file_prefix);
-#endif
-
-    // zero pad the rank number;
-    std::string::size_type n_zeros = 4;
-    std::string rank_num = std::to_string(amrex::ParallelDescriptor::MyProc());
-    std::string pad_rank_num = std::string(n_zeros-std::min(rank_num.size(), n_zeros),'0')+rank_num;
-
-    // open file
-    std::ofstream ofs{m_insitu_file_prefix + "/reduced_" + m_name + "." + pad_rank_num + ".txt",
-        std::ofstream::out | std::ofstream::app | std::ofstream::binary};
-
     const amrex::Real sum_w0 = m_insitu_sum_rdata[0];
     const std::size_t nslices = static_cast<std::size_t>(m_nslices);
     const amrex::Real normalized_density_factor = Hipace::m_normalized_units ?
@@ -702,23 +810,9 @@ BeamParticleContainer::InSituWriteToFile (int step, amrex::Real time, const amre
         insitu_utils::merge_data(all_data, all_spin_data);
     }
 
-    if (ofs.tellp() == 0) {
-        // write JSON header containing a NumPy structured datatype
-        insitu_utils::write_header(all_data, ofs);
-    }
-
-    // write binary data according to datatype in header
-    insitu_utils::write_data(all_data, ofs);
+    m_insitu_histograms.AddToDataNodes(all_data);
 
-    // close file
-    ofs.close();
-    // assert no file errors
-#ifdef HIPACE_USE_OPENPMD
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu beam diagnostics");
-#else
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu beam diagnostics. "
-        "Maybe the specified subdirectory does not exist");
-#endif
+    Hipace::GetInstance().m_insitu_writer.Write(m_insitu_file_prefix, m_name, step, all_data);
 
     // reset arrays for insitu data
     for (auto& x : m_insitu_rdata) x = 0.;
@@ -729,4 +823,5 @@ BeamParticleContainer::InSituWriteToFile (int step, amrex::Real time, const amre
         for (auto& x : m_insitu_spin_data) x = 0.;
         for (auto& x : m_insitu_sum_spin_data) x = 0.;
     }
+    m_insitu_histograms.Reset();
 }
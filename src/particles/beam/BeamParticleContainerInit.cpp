@@ -16,7 +16,10 @@
 
 #ifdef HIPACE_USE_OPENPMD
 #include <openPMD/openPMD.hpp>
+#include <AMReX_Scan.H>
+#include <algorithm>
 #include <iostream> // std::cout
+#include <limits>
 #include <memory>   // std::shared_ptr
 #endif  // HIPACE_USE_OPENPMD
 
@@ -106,6 +109,7 @@ namespace
 
         ptd.idata(BeamIdx::nsubcycles)[ip] = 0;
         ptd.idata(BeamIdx::mr_level)[ip] = 0;
+        ptd.idata(BeamIdx::nsubcycles_total)[ip] = 0;
 
         ptd.idcpu(ip) = pid + ip;
         if (is_valid) {
@@ -966,40 +970,6 @@ InitBeamFromFile (const std::string input_file,
 
     auto electrons = series.iterations[num_iteration].particles[name_particle];
 
-    const auto num_to_add = electrons[name_r][name_rx].getExtent()[0];
-
-    if(num_to_add >= 2147483647) {
-        amrex::Abort("Beam from file can't have more than 2'147'483'646 Particles\n");
-    }
-
-    auto del = [](input_type *p){ amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p)); };
-
-    // copy Data to pinned memory
-    std::shared_ptr<input_type> r_x_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> r_y_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> r_z_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> u_x_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> u_y_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> u_z_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-    std::shared_ptr<input_type> w_w_data{ reinterpret_cast<input_type*>(
-        amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*num_to_add) ), del};
-
-    electrons[name_r][name_rx].loadChunk<input_type>(r_x_data, {0u}, {num_to_add});
-    electrons[name_r][name_ry].loadChunk<input_type>(r_y_data, {0u}, {num_to_add});
-    electrons[name_r][name_rz].loadChunk<input_type>(r_z_data, {0u}, {num_to_add});
-    electrons[name_u][name_ux].loadChunk<input_type>(u_x_data, {0u}, {num_to_add});
-    electrons[name_u][name_uy].loadChunk<input_type>(u_y_data, {0u}, {num_to_add});
-    electrons[name_u][name_uz].loadChunk<input_type>(u_z_data, {0u}, {num_to_add});
-    electrons[name_w][name_ww].loadChunk<input_type>(w_w_data, {0u}, {num_to_add});
-
-    series.flush();
-
     // calculate the multiplier to convert to Hipace units
     if(Hipace::m_normalized_units) {
         if(n_0 == 0) {
@@ -1047,16 +1017,28 @@ InitBeamFromFile (const std::string input_file,
         unit_ww = electrons[name_w][name_ww].unitSI() / si_to_norm_weight;
     }
 
-    // input data using AddOneBeamParticle function, make necessary variables and arrays
-    auto& particle_tile = getBeamInitSlice();
-    auto old_size = particle_tile.size();
-    auto new_size = old_size + num_to_add;
-    particle_tile.resize(new_size);
-    const auto ptd = particle_tile.getParticleTileData();
-    const auto enforceBC = EnforceBC();
+    // Read the file in chunks, so only one chunk of every dataset is held in pinned memory.
+    // Particles outside of the longitudinal domain are never used and are not stored.
+    const uint64_t num_in_file = electrons[name_r][name_rx].getExtent()[0];
+    const uint64_t chunk_size = std::max<uint64_t>(1, m_file_chunk_size > 0 ?
+        std::min<uint64_t>(m_file_chunk_size, num_in_file) : num_in_file);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(chunk_size < uint64_t(std::numeric_limits<int>::max()),
+        "The chunk size of a beam from file must be smaller than 2^31, "
+        "use <beam name>.file_chunk_size");
 
-    const uint64_t pid = m_id64;
-    m_id64 += num_to_add;
+    auto del = [](input_type *p){ amrex::The_Pinned_Arena()->free(reinterpret_cast<void*>(p)); };
+    auto alloc_chunk = [&] () {
+        return std::shared_ptr<input_type>{ reinterpret_cast<input_type*>(
+            amrex::The_Pinned_Arena()->alloc(sizeof(input_type)*chunk_size) ), del};
+    };
+
+    std::shared_ptr<input_type> r_x_data = alloc_chunk();
+    std::shared_ptr<input_type> r_y_data = alloc_chunk();
+    std::shared_ptr<input_type> r_z_data = alloc_chunk();
+    std::shared_ptr<input_type> u_x_data = alloc_chunk();
+    std::shared_ptr<input_type> u_y_data = alloc_chunk();
+    std::shared_ptr<input_type> u_z_data = alloc_chunk();
+    std::shared_ptr<input_type> w_w_data = alloc_chunk();
 
     const input_type * const r_x_ptr = r_x_data.get();
     const input_type * const r_y_ptr = r_y_data.get();
@@ -1066,20 +1048,68 @@ InitBeamFromFile (const std::string input_file,
     const input_type * const u_z_ptr = u_z_data.get();
     const input_type * const w_w_ptr = w_w_data.get();
 
-    amrex::ParallelFor(amrex::Long(num_to_add),
-        [=] AMREX_GPU_DEVICE (const amrex::Long i) {
-            AddOneBeamParticle(ptd,
-                static_cast<amrex::Real>(r_x_ptr[i] * unit_rx),
-                static_cast<amrex::Real>(r_y_ptr[i] * unit_ry),
-                static_cast<amrex::Real>(r_z_ptr[i] * unit_rz),
-                static_cast<amrex::Real>(u_x_ptr[i] * unit_ux), // = gamma * beta
-                static_cast<amrex::Real>(u_y_ptr[i] * unit_uy),
-                static_cast<amrex::Real>(u_z_ptr[i] * unit_uz),
-                static_cast<amrex::Real>(w_w_ptr[i] * unit_ww),
-                pid, i, phys_const.c, enforceBC);
-        });
+    // same binning as in BoxSorter::sortParticlesByBox
+    const int num_boxes = geom.Domain().length(2);
+    const amrex::Real dzi = geom.InvCellSize(2);
+    const amrex::Real plo_z = geom.ProbLo(2);
 
-    amrex::Gpu::streamSynchronize();
+    auto& particle_tile = getBeamInitSlice();
+    const auto enforceBC = EnforceBC();
+    uint64_t num_kept = 0;
+
+    for (uint64_t chunk_start = 0; chunk_start < num_in_file; chunk_start += chunk_size) {
+        const uint64_t num_chunk = std::min(chunk_size, num_in_file - chunk_start);
+
+        electrons[name_r][name_rx].loadChunk<input_type>(r_x_data, {chunk_start}, {num_chunk});
+        electrons[name_r][name_ry].loadChunk<input_type>(r_y_data, {chunk_start}, {num_chunk});
+        electrons[name_r][name_rz].loadChunk<input_type>(r_z_data, {chunk_start}, {num_chunk});
+        electrons[name_u][name_ux].loadChunk<input_type>(u_x_data, {chunk_start}, {num_chunk});
+        electrons[name_u][name_uy].loadChunk<input_type>(u_y_data, {chunk_start}, {num_chunk});
+        electrons[name_u][name_uz].loadChunk<input_type>(u_z_data, {chunk_start}, {num_chunk});
+        electrons[name_w][name_ww].loadChunk<input_type>(w_w_data, {chunk_start}, {num_chunk});
+
+        series.flush();
+
+        // input data using AddOneBeamParticle function, make necessary variables and arrays
+        const amrex::Long old_size = particle_tile.size();
+        particle_tile.resize(old_size + num_chunk);
+        const auto ptd = particle_tile.getParticleTileData();
+
+        // the particle at tile index ip gets the id m_id64 + ip - (old_size - num_kept)
+        const amrex::Long pid = static_cast<amrex::Long>(m_id64 + num_kept) - old_size;
+
+        const amrex::Long num_added = amrex::Scan::PrefixSum<amrex::Long>(int(num_chunk),
+            [=] AMREX_GPU_DEVICE (int i) -> amrex::Long {
+                const int dst_box = static_cast<int>((r_z_ptr[i] * unit_rz - plo_z) * dzi);
+                return (dst_box >= 0 && dst_box < num_boxes) ? 1 : 0;
+            },
+            [=] AMREX_GPU_DEVICE (int i, amrex::Long s) {
+                const int dst_box = static_cast<int>((r_z_ptr[i] * unit_rz - plo_z) * dzi);
+                if (dst_box < 0 || dst_box >= num_boxes) return;
+                AddOneBeamParticle(ptd,
+                    static_cast<amrex::Real>(r_x_ptr[i] * unit_rx),
+                    static_cast<amrex::Real>(r_y_ptr[i] * unit_ry),
+                    static_cast<amrex::Real>(r_z_ptr[i] * unit_rz),
+                    static_cast<amrex::Real>(u_x_ptr[i] * unit_ux), // = gamma * beta
+                    static_cast<amrex::Real>(u_y_ptr[i] * unit_uy),
+                    static_cast<amrex::Real>(u_z_ptr[i] * unit_uz),
+                    static_cast<amrex::Real>(w_w_ptr[i] * unit_ww),
+                    pid, old_size + s, phys_const.c, enforceBC);
+            },
+            amrex::Scan::Type::exclusive, amrex::Scan::retSum);
+
+        // shrinking does not reallocate
+        particle_tile.resize(old_size + num_added);
+        num_kept += num_added;
+    }
+
+    m_id64 += num_kept;
+
+    if (Hipace::m_verbose >= 2 && num_kept != num_in_file) {
+        amrex::Print() << "Beam '" << m_name << "': " << num_in_file - num_kept << " of "
+                       << num_in_file << " particles in the input file are outside of the "
+                       << "longitudinal domain and were discarded\n";
+    }
 
     return physical_time;
 }
@@ -108,6 +108,25 @@ MultiBeam::InSituWriteToFile (int step, amrex::Real time, const amrex::Geometry&
     }
 }
 
+void
+MultiBeam::ReportSubcyclingStats (int step, bool do_print)
+{
+    for (auto& beam : m_all_beams) {
+        if (!beam.m_adaptive_subcycling) continue;
+        amrex::Gpu::HostVector<unsigned long long> stats(beam.m_subcycling_stats.size());
+        amrex::Gpu::copy(amrex::Gpu::deviceToHost, beam.m_subcycling_stats.begin(),
+                         beam.m_subcycling_stats.end(), stats.begin());
+        beam.m_subcycling_stats.assign(beam.m_subcycling_stats.size(), 0);
+        if (do_print) {
+            const double avg = stats[1] > 0 ? double(stats[0]) / double(stats[1]) : 0.;
+            amrex::AllPrint() << "Rank " << amrex::ParallelDescriptor::MyProc()
+                              << ": step " << step << " beam " << beam.get_name() << ": "
+                              << stats[0] << " sub-cycles for " << stats[1] << " particles, avg. "
+                              << avg << " per particle (max " << beam.m_n_subcycles_max << ")\n";
+        }
+    }
+}
+
 void
 MultiBeam::ReorderParticles (int beam_slice, int step, amrex::Geometry& slice_geom)
 {
@@ -18,6 +18,43 @@
 #include "utils/Constants.H"
 #include "utils/GPUUtil.H"
 
+PlasmaDepositParams
+GetPlasmaDepositParams (const PlasmaParticleContainer& plasma, const int which_slice,
+                        amrex::Vector<amrex::Geometry> const& gm, int const lev,
+                        const amrex::Box& box, int* p_n_qsa_violation)
+{
+    using namespace amrex::literals;
+
+    const amrex::Real charge = (which_slice == WhichSlice::RhomJzIons) ? -plasma.m_charge : plasma.m_charge;
+    const amrex::Real mass = plasma.m_mass;
+
+    // Extract box properties
+    const amrex::Real dx_inv = gm[lev].InvCellSize(0);
+    const amrex::Real dy_inv = gm[lev].InvCellSize(1);
+    const amrex::Real dz_inv = gm[lev].InvCellSize(2);
+    // in normalized units this is rescaling dx and dy for MR,
+    // while in SI units it's the factor for charge to charge density
+    const amrex::Real invvol = Hipace::m_normalized_units ?
+        gm[0].CellSize(0)*gm[0].CellSize(1)*dx_inv*dy_inv
+        : dx_inv*dy_inv*dz_inv;
+
+    const PhysConst pc = get_phys_const();
+
+    PlasmaDepositParams p;
+    // Offset for converting positions to indexes
+    p.x_pos_offset = GetPosOffset(0, gm[lev], box);
+    p.y_pos_offset = GetPosOffset(1, gm[lev], box);
+    p.dx_inv = dx_inv;
+    p.dy_inv = dy_inv;
+    p.clight = pc.c;
+    p.clightinv = 1.0_rt/pc.c;
+    p.charge_invvol = charge * invvol;
+    p.charge_mu0_mass_ratio = charge * pc.mu0 / mass;
+    p.laser_norm = (charge/pc.q_e) * (pc.m_e/mass) * (charge/pc.q_e) * (pc.m_e/mass);
+    p.max_qsa_weighting_factor = plasma.m_max_qsa_weighting_factor;
+    p.p_n_qsa_violation = p_n_qsa_violation;
+    return p;
+}
 
 void
 DepositCurrent (PlasmaParticleContainer& plasma, Fields & fields,
@@ -36,9 +73,6 @@ DepositCurrent (PlasmaParticleContainer& plasma, Fields & fields,
     " (WhichSlice::Next), for the ion charge deposition (WhichSLice::RhomJzIons)"
     " or for the Salame slice (WhichSlice::Salame)");
 
-    const amrex::Real max_qsa_weighting_factor = plasma.m_max_qsa_weighting_factor;
-    const amrex::Real charge = (which_slice == WhichSlice::RhomJzIons) ? -plasma.m_charge : plasma.m_charge;
-    const amrex::Real mass = plasma.m_mass;
     // only deposit rho individual on WhichSlice::This
     const bool deposit_rho_individual = Hipace::m_deposit_rho_individual && which_slice == WhichSlice::This;
     const std::string rho_str = deposit_rho_individual ? "rho_" + plasma.GetName() : "rho";
@@ -65,24 +99,16 @@ DepositCurrent (PlasmaParticleContainer& plasma, Fields & fields,
         // Extract box properties
         const amrex::Real dx_inv = gm[lev].InvCellSize(0);
         const amrex::Real dy_inv = gm[lev].InvCellSize(1);
-        const amrex::Real dz_inv = gm[lev].InvCellSize(2);
-        // in normalized units this is rescaling dx and dy for MR,
-        // while in SI units it's the factor for charge to charge density
-        const amrex::Real invvol = Hipace::m_normalized_units ?
-            gm[0].CellSize(0)*gm[0].CellSize(1)*dx_inv*dy_inv
-            : dx_inv*dy_inv*dz_inv;
-
-        const PhysConst pc = get_phys_const();
-        const amrex::Real clight = pc.c;
-        const amrex::Real clightinv = 1.0_rt/pc.c;
-        const amrex::Real charge_invvol = charge * invvol;
-        const amrex::Real charge_mu0_mass_ratio = charge * pc.mu0 / mass;
-        const amrex::Real laser_norm = (charge/pc.q_e) * (pc.m_e/mass)
-                                     * (charge/pc.q_e) * (pc.m_e/mass);
 
         int n_qsa_violation = 0;
         amrex::Gpu::DeviceScalar<int> gpu_n_qsa_violation(n_qsa_violation);
-        int* const AMREX_RESTRICT p_n_qsa_violation = gpu_n_qsa_violation.dataPtr();
+
+        const PlasmaDepositParams params = GetPlasmaDepositParams(plasma, which_slice, gm, lev,
+            isl_fab.box(), gpu_n_qsa_violation.dataPtr());
+
+        // reuse the tile binning of the incremental sort if the particles did not move since then
+        const int* tile_offsets = plasma.m_tile_sorter.tileOffsetsPtr(
+            int(pti.numParticles()), isl_fab.box());
 
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(isl_fab.box().ixType().cellCentered(),
             "jx, jy, jz, and rho must be cell centered in all directions.");
@@ -112,13 +138,13 @@ DepositCurrent (PlasmaParticleContainer& plasma, Fields & fields,
                         int(pti.numParticles()), is_valid, get_cell, deposit, isl_fab.array(),
                         isl_fab.box(), pti.GetParticleTile().getParticleTileData(),
                         amrex::GpuArray<int, 1>{aabs},
-                        amrex::GpuArray<int, 6>{jx, jy, jz, rho, chi, rhomjz});
+                        amrex::GpuArray<int, 6>{jx, jy, jz, rho, chi, rhomjz}, tile_offsets);
                 } else {
                     SharedMemoryDeposition<stencil_size, stencil_size, true>(
                         int(pti.numParticles()), is_valid, get_cell, deposit, isl_fab.array(),
                         isl_fab.box(), pti.GetParticleTile().getParticleTileData(),
                         amrex::GpuArray<int, 0>{},
-                        amrex::GpuArray<int, 6>{jx, jy, jz, rho, chi, rhomjz});
+                        amrex::GpuArray<int, 6>{jx, jy, jz, rho, chi, rhomjz}, tile_offsets);
                 }
             },
             // is_valid
@@ -161,90 +187,12 @@ DepositCurrent (PlasmaParticleContainer& plasma, Fields & fields,
                                   auto can_ionize,
                                   auto use_laser) noexcept
             {
-                const amrex::Real psi_inv = 1._rt/ptd.rdata(PlasmaIdx::psi)[ip];
-                const amrex::Real xp = ptd.pos(0, ip);
-                const amrex::Real yp = ptd.pos(1, ip);
-                const amrex::Real vx_c = ptd.rdata(PlasmaIdx::ux)[ip] * psi_inv;
-                const amrex::Real vy_c = ptd.rdata(PlasmaIdx::uy)[ip] * psi_inv;
-
-                // calculate charge of the plasma particles
-                amrex::Real q_invvol = charge_invvol * ptd.rdata(PlasmaIdx::w)[ip];
-                amrex::Real q_mu0_mass_ratio = charge_mu0_mass_ratio;
-                [[maybe_unused]] amrex::Real laser_norm_ion = laser_norm;
-                if constexpr (can_ionize) {
-                    q_invvol *= ptd.idata(PlasmaIdx::ion_lev)[ip];
-                    q_mu0_mass_ratio *= ptd.idata(PlasmaIdx::ion_lev)[ip];
-                    laser_norm_ion *=
-                        ptd.idata(PlasmaIdx::ion_lev)[ip] * ptd.idata(PlasmaIdx::ion_lev)[ip];
-                }
-
-                const amrex::Real xmid = (xp - x_pos_offset) * dx_inv;
-                const amrex::Real ymid = (yp - y_pos_offset) * dy_inv;
-
-                amrex::Real Aabssqp = 0._rt;
+                int aabs_idx = -1;
                 if constexpr (use_laser) {
-                    doLaserGatherShapeN<depos_order>(xp, yp, Aabssqp, arr, cache_idx[0],
-                                                    dx_inv, dy_inv, x_pos_offset, y_pos_offset);
-                    Aabssqp *= laser_norm_ion;
-                }
-
-                // calculate gamma/psi for plasma particles
-                const amrex::Real gamma_psi = 0.5_rt * (
-                    (1._rt + 0.5_rt * Aabssqp) * psi_inv * psi_inv
-                    + vx_c * vx_c * clightinv * clightinv
-                    + vy_c * vy_c * clightinv * clightinv
-                    + 1._rt
-                );
-
-                if (gamma_psi < 0.0_rt || gamma_psi > max_qsa_weighting_factor || psi_inv < 0.0_rt)
-                {
-                    // This particle violates the QSA, discard it and do not deposit its current
-                    amrex::Gpu::Atomic::Add(p_n_qsa_violation, 1);
-                    ptd.rdata(PlasmaIdx::w)[ip] = 0.0_rt;
-                    ptd.id(ip).make_invalid();
-                    return;
-                }
-
-                for (int iy=0; iy <= depos_order; ++iy) {
-                    for (int ix=0; ix <= depos_order; ++ix) {
-
-                        // --- Compute shape factors
-                        // x direction
-                        auto [shape_x, i] =
-                            compute_single_shape_factor<false, depos_order>(xmid, ix);
-
-                        // y direction
-                        auto [shape_y, j] =
-                            compute_single_shape_factor<false, depos_order>(ymid, iy);
-
-                        const amrex::Real charge_density = q_invvol * shape_x * shape_y;
-                        // wqx, wqy wqz are particle current in each direction
-                        const amrex::Real wqx     = charge_density * vx_c;
-                        const amrex::Real wqy     = charge_density * vy_c;
-                        const amrex::Real wqz     = charge_density * (gamma_psi-1._rt) * clight;
-                        const amrex::Real wq      = charge_density * gamma_psi;
-                        const amrex::Real wchi    = charge_density * q_mu0_mass_ratio * psi_inv;
-                        const amrex::Real wrhomjz = charge_density;
-
-                        // Deposit current into arr
-                        if (depos_idx[0] != -1) { // deposit_jx_jy
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[0]), wqx);
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[1]), wqy);
-                        }
-                        if (depos_idx[2] != -1) { // deposit_jz
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[2]), wqz);
-                        }
-                        if (depos_idx[3] != -1) { // deposit_rho
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[3]), wq);
-                        }
-                        if (depos_idx[4] != -1) { // deposit_chi
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[4]), wchi);
-                        }
-                        if (depos_idx[5] != -1) { // deposit_rhomjz
-                            amrex::Gpu::Atomic::Add(arr.ptr(i, j, depos_idx[5]), wrhomjz);
-                        }
-                    }
+                    aabs_idx = cache_idx[0];
                 }
+                DepositPlasmaParticle<depos_order, can_ionize, use_laser, false>(
+                    ip, ptd, arr, aabs_idx, depos_idx, params);
             });
 
         n_qsa_violation = gpu_n_qsa_violation.dataValue();
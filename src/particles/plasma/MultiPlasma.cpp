@@ -96,10 +96,11 @@ MultiPlasma::ExplicitDeposition (Fields& fields, amrex::Vector<amrex::Geometry>
 
 void
 MultiPlasma::AdvanceParticles (
-    const Fields & fields, amrex::Vector<amrex::Geometry> const& gm, bool temp_slice, int lev)
+    Fields & fields, amrex::Vector<amrex::Geometry> const& gm, bool temp_slice, int lev,
+    bool deposit_next)
 {
     for (int i=0; i<m_nplasmas; i++) {
-        AdvancePlasmaParticles(m_all_plasmas[i], fields, gm, temp_slice, lev);
+        AdvancePlasmaParticles(m_all_plasmas[i], fields, gm, temp_slice, lev, deposit_next);
     }
 }
 
@@ -147,10 +148,11 @@ MultiPlasma::AnySpeciesNeutralizeBackground () const
 }
 
 void
-MultiPlasma::ReorderParticles (const int islice)
+MultiPlasma::ReorderParticles (const int islice, const amrex::Box& box,
+                               const amrex::Geometry& geom)
 {
     for (auto& plasma : m_all_plasmas) {
-        plasma.ReorderParticles(islice);
+        plasma.ReorderParticles(islice, box, geom);
     }
 }
 
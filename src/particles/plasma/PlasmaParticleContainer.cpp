@@ -13,15 +13,13 @@
 #include "utils/DeprecatedInput.H"
 #include "utils/GPUUtil.H"
 #include "utils/InsituUtil.H"
-#ifdef HIPACE_USE_OPENPMD
-#   include <openPMD/auxiliary/Filesystem.hpp>
-#endif
 #include "particles/pusher/PlasmaParticleAdvance.H"
 #include "particles/pusher/BeamParticleAdvance.H"
 #include "particles/particles_utils/FieldGather.H"
 #include "particles/pusher/GetAndSetPosition.H"
 #include <cmath>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 void
@@ -86,6 +84,8 @@ PlasmaParticleContainer::ReadParameters ()
         m_charge *= m_init_ion_lev;
     }
     queryWithParser(pp, "ionization_product", m_product_name);
+    queryWithParserAlt(pp, "ionization_table_size", m_adk_table_size, pp_alt);
+    queryWithParserAlt(pp, "ionization_table_tolerance", m_adk_table_tolerance, pp_alt);
 
     std::string density_func_str = "0.";
     DeprecatedInput(m_name, "density", "density(x,y,z)");
@@ -117,6 +117,13 @@ PlasmaParticleContainer::ReadParameters ()
         file.close();
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_density_table.empty(),
                                          "Unable to get any data out of 'density_table_file'");
+        // compile all functions once instead of every time the table entry changes
+        m_density_table_parser.resize(m_density_table.size());
+        for (const auto& [pos, density] : m_density_table) {
+            const int idx = m_density_table_func.size();
+            m_density_table_func.push_back(makeFunctionWithParser<3>(
+                density, m_density_table_parser[idx], {"x", "y", "z"}));
+        }
     }
 
     queryWithParserAlt(pp, "radius", m_radius, pp_alt);
@@ -144,11 +151,13 @@ PlasmaParticleContainer::ReadParameters ()
         }
     }
 
+    queryWithParserAlt(pp, "cache_initial_state", m_cache_initial_state, pp_alt);
     queryWithParserAlt(pp, "reorder_period", m_reorder_period, pp_alt);
     amrex::Array<int, 2> idx_array
         {Hipace::m_depos_order_xy % 2, Hipace::m_depos_order_xy % 2};
     queryWithParserAlt(pp, "reorder_idx_type", idx_array, pp_alt);
     m_reorder_idx_type = amrex::IntVect(idx_array[0], idx_array[1], 0);
+    queryWithParserAlt(pp, "incremental_reorder", m_incremental_reorder, pp_alt);
     queryWithParserAlt(pp, "insitu_period", m_insitu_period, pp_alt);
     queryWithParserAlt(pp, "insitu_file_prefix", m_insitu_file_prefix, pp_alt);
 
@@ -173,10 +182,18 @@ PlasmaParticleContainer::ReadParameters ()
 void
 PlasmaParticleContainer::InitData (const amrex::Geometry& geom)
 {
+    m_tile_sorter.invalidate();
     reserveData();
     resizeData();
 
-    InitParticles(m_u_std, m_u_mean, m_radius, m_hollow_core_radius);
+    if (m_cache_initial_state && InitialStateIsValid()) {
+        RestoreInitialState();
+    } else {
+        InitParticles(m_u_std, m_u_mean, m_radius, m_hollow_core_radius);
+        if (m_cache_initial_state) {
+            StoreInitialState();
+        }
+    }
 
     if (m_insitu_period > 0) {
 #ifdef HIPACE_USE_OPENPMD
@@ -194,10 +211,15 @@ PlasmaParticleContainer::InitData (const amrex::Geometry& geom)
 }
 
 void
-PlasmaParticleContainer::ReorderParticles (const int islice)
+PlasmaParticleContainer::ReorderParticles (const int islice, const amrex::Box& box,
+                                           const amrex::Geometry& geom)
 {
     if (m_reorder_period > 0 && islice % m_reorder_period == 0) {
         HIPACE_PROFILE("PlasmaParticleContainer::ReorderParticles()");
+        if (m_incremental_reorder) {
+            m_tile_sorter.sortParticlesByTile(*this, box, geom);
+            return;
+        }
 #if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
         // SortParticlesForDeposition only works for CUDA and HIP
         SortParticlesForDeposition(m_reorder_idx_type);
@@ -213,7 +235,59 @@ PlasmaParticleContainer::UpdateDensityFunction (const amrex::Real pos_z)
     if (!m_use_density_table) return;
     auto iter = m_density_table.lower_bound(pos_z);
     if (iter == m_density_table.end()) --iter;
-    m_density_func = makeFunctionWithParser<3>(iter->second, m_parser, {"x", "y", "z"});
+    const auto idx = std::distance(m_density_table.begin(), iter);
+    m_parser = m_density_table_parser[idx];
+    m_density_func = m_density_table_func[idx];
+}
+
+void
+PlasmaParticleContainer::StoreInitialState ()
+{
+    HIPACE_PROFILE("PlasmaParticleContainer::StoreInitialState()");
+
+    // With a z dependent density, the plasma is different at every time step
+    m_init_state_is_stored = m_parser.symbols().count("z") == 0;
+    if (!m_init_state_is_stored) return;
+
+    if (m_use_density_table) {
+        auto iter = m_density_table.lower_bound(get_phys_const().c * Hipace::m_physical_time);
+        if (iter == m_density_table.end()) --iter;
+        m_init_state_table_pos = iter->first;
+    }
+
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(GetParticles(0).size() <= 1,
+        "cache_initial_state only works with a single plasma tile per rank");
+
+    m_init_state.resize(0);
+    for (PlasmaParticleIterator pti(*this); pti.isValid(); ++pti) {
+        m_init_state.resize(pti.numParticles());
+        amrex::copyParticles(m_init_state, pti.GetParticleTile());
+    }
+}
+
+bool
+PlasmaParticleContainer::InitialStateIsValid () const
+{
+    if (!m_init_state_is_stored) return false;
+    if (m_use_density_table) {
+        auto iter = m_density_table.lower_bound(get_phys_const().c * Hipace::m_physical_time);
+        if (iter == m_density_table.end()) --iter;
+        if (iter->first != m_init_state_table_pos) return false;
+    }
+    return true;
+}
+
+void
+PlasmaParticleContainer::RestoreInitialState ()
+{
+    HIPACE_PROFILE("PlasmaParticleContainer::RestoreInitialState()");
+
+    clearParticles();
+    for (amrex::MFIter mfi = MakeMFIter(0, DfltMfi); mfi.isValid(); ++mfi) {
+        auto& particle_tile = DefineAndReturnParticleTile(0, mfi.index(), mfi.LocalTileIndex());
+        particle_tile.resize(m_init_state.numParticles());
+        amrex::copyParticles(particle_tile, m_init_state);
+    }
 }
 
 void
@@ -328,6 +402,10 @@ IonizationModule (const int lev,
         amrex::Real* AMREX_RESTRICT adk_prefactor = m_adk_prefactor.data();
         amrex::Real* AMREX_RESTRICT adk_exp_prefactor = m_adk_exp_prefactor.data();
         amrex::Real* AMREX_RESTRICT adk_power = m_adk_power.data();
+        const amrex::Real* AMREX_RESTRICT adk_table = m_adk_log_rate_table.data();
+        const int adk_table_size = m_adk_table_size;
+        const amrex::Real adk_table_log_emin = m_adk_table_log_emin;
+        const amrex::Real adk_table_inv_dlog = m_adk_table_inv_dlog;
 
         long num_ions = ptile_ion.numParticles();
 
@@ -359,10 +437,29 @@ IonizationModule (const int lev,
                                                + uyp[ip] * uyp[ip] * clightsq
                                                + psip[ip]* psip[ip] ) / ( 2.0_rt * psip[ip] );
             const int ion_lev_loc = ion_lev[ip];
+            amrex::Real w_dt = 0._rt;
+            if (adk_table_size > 0) {
+                // interpolate log(w * dt) in log(E) with a cubic Hermite polynomial,
+                // the value at the end of the table is used above it
+                const amrex::Real x = (std::log(Ep) - adk_table_log_emin) * adk_table_inv_dlog;
+                // the ionization probability is negligible below the table
+                if (x > 0._rt) {
+                    const int i = amrex::min(static_cast<int>(x), adk_table_size - 2);
+                    const amrex::Real t = amrex::min(x - i, 1._rt);
+                    const amrex::Real* table = adk_table + 2 * (ion_lev_loc * adk_table_size + i);
+                    const amrex::Real f0 = table[0];
+                    const amrex::Real d0 = table[1];
+                    const amrex::Real f1 = table[2];
+                    const amrex::Real d1 = table[3];
+                    w_dt = std::exp(f0 + t * (d0 + t * ((3._rt * (f1 - f0) - 2._rt * d0 - d1)
+                                                      + t * (2._rt * (f0 - f1) + d0 + d1))));
+                }
+            } else {
+                w_dt = adk_prefactor[ion_lev_loc] * std::pow(Ep, adk_power[ion_lev_loc]) *
+                    std::exp( adk_exp_prefactor[ion_lev_loc]/Ep );
+            }
             // gamma / (psi + 1) to complete dt for QSA
-            amrex::Real w_dtau = gammap / psip[ip] * adk_prefactor[ion_lev_loc] *
-                std::pow(Ep, adk_power[ion_lev_loc]) *
-                std::exp( adk_exp_prefactor[ion_lev_loc]/Ep );
+            amrex::Real w_dtau = gammap / psip[ip] * w_dt;
             amrex::Real p = 1._rt - std::exp( - w_dtau );
 
             amrex::Real random_draw = amrex::Random(engine);
@@ -531,20 +628,6 @@ PlasmaParticleContainer::InSituWriteToFile (int step, amrex::Real time, const am
 {
     HIPACE_PROFILE("PlasmaParticleContainer::InSituWriteToFile()");
 
-#ifdef HIPACE_USE_OPENPMD
-    // create subdirectory
-    openPMD::auxiliary::create_directories(m_insitu_file_prefix);
-#endif
-
-    // zero pad the rank number;
-    std::string::size_type n_zeros = 4;
-    std::string rank_num = std::to_string(amrex::ParallelDescriptor::MyProc());
-    std::string pad_rank_num = std::string(n_zeros-std::min(rank_num.size(), n_zeros),'0')+rank_num;
-
-    // open file
-    std::ofstream ofs{m_insitu_file_prefix + "/reduced_" + m_name + "." + pad_rank_num + ".txt",
-        std::ofstream::out | std::ofstream::app | std::ofstream::binary};
-
     const amrex::Real sum_w0 = m_insitu_sum_rdata[0];
     const std::size_t nslices = static_cast<std::size_t>(m_nslices);
     const amrex::Real normalized_density_factor = Hipace::m_normalized_units ?
@@ -599,23 +682,7 @@ PlasmaParticleContainer::InSituWriteToFile (int step, amrex::Real time, const am
         }}
     };
 
-    if (ofs.tellp() == 0) {
-        // write JSON header containing a NumPy structured datatype
-        insitu_utils::write_header(all_data, ofs);
-    }
-
-    // write binary data according to datatype in header
-    insitu_utils::write_data(all_data, ofs);
-
-    // close file
-    ofs.close();
-    // assert no file errors
-#ifdef HIPACE_USE_OPENPMD
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu plasma diagnostics");
-#else
-    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ofs, "Error while writing insitu plasma diagnostics. "
-        "Maybe the specified subdirectory does not exist");
-#endif
+    Hipace::GetInstance().m_insitu_writer.Write(m_insitu_file_prefix, m_name, step, all_data);
 
     // reset arrays for insitu data
     for (auto& x : m_insitu_rdata) x = 0.;
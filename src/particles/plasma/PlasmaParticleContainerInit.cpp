@@ -12,6 +12,7 @@
 #include "Hipace.H"
 #include "utils/HipaceProfilerWrapper.H"
 #include "utils/IonizationEnergiesTable.H"
+#include <algorithm>
 #include <cmath>
 
 void
@@ -458,4 +459,82 @@ InitIonizationModule (const amrex::Geometry& geom, PlasmaParticleContainer* prod
         h_adk_prefactor.begin(), h_adk_prefactor.end(), m_adk_prefactor.begin());
     amrex::Gpu::copy(amrex::Gpu::hostToDevice,
         h_adk_exp_prefactor.begin(), h_adk_exp_prefactor.end(), m_adk_exp_prefactor.begin());
+
+    if (m_adk_table_size <= 0) return;
+
+    // Tabulate log(w * dt) of every ion level on a log-spaced grid of |E|, so the ionization
+    // kernel only needs to interpolate instead of evaluating pow and exp of the ADK formula.
+    // log(w * dt) = log(prefactor) + power * log(E) + exp_prefactor / E is smooth in log(E),
+    // so it is interpolated with cubic Hermite polynomials from its values and slopes.
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_adk_table_size >= 2,
+        "ionization_table_size must be at least 2, or 0 to disable the table");
+    const int ntable = m_adk_table_size;
+    auto log_rate = [&] (int i, double log_e) {
+        return std::log(static_cast<double>(h_adk_prefactor[i]))
+            + h_adk_power[i] * log_e + h_adk_exp_prefactor[i] * std::exp(-log_e);
+    };
+    auto log_rate_slope = [&] (int i, double log_e) {
+        return h_adk_power[i] - h_adk_exp_prefactor[i] * std::exp(-log_e);
+    };
+    // below log_e_min, w * dt < 1e-30 for all ion levels
+    const double log_rate_negligible = std::log(1.e-30);
+    double log_e_min = std::log(1.e-3 * Ea);
+    for (int iter=0; iter<100; ++iter) {
+        bool negligible = true;
+        for (int i=0; i<ion_atomic_number; ++i) {
+            negligible = negligible && log_rate(i, log_e_min) < log_rate_negligible;
+        }
+        if (negligible) break;
+        log_e_min -= std::log(2.);
+    }
+    // far above the barrier-suppression field of all ion levels
+    const double log_e_max = std::log(1.e3 * Ea);
+    const double dlog = (log_e_max - log_e_min) / (ntable - 1);
+
+    // value and slope times the spacing of every point
+    amrex::Gpu::PinnedVector<amrex::Real> h_adk_log_rate_table(2 * ion_atomic_number * ntable);
+    for (int i=0; i<ion_atomic_number; ++i) {
+        for (int j=0; j<ntable; ++j) {
+            const double log_e = log_e_min + j * dlog;
+            h_adk_log_rate_table[2*(i*ntable + j)] =
+                static_cast<amrex::Real>(log_rate(i, log_e));
+            h_adk_log_rate_table[2*(i*ntable + j) + 1] =
+                static_cast<amrex::Real>(dlog * log_rate_slope(i, log_e));
+        }
+    }
+    m_adk_table_log_emin = static_cast<amrex::Real>(log_e_min);
+    m_adk_table_inv_dlog = static_cast<amrex::Real>(1. / dlog);
+
+    // compare the interpolation of the table with the ADK formula in the middle between all
+    // table points where the rate is not negligible, the relative error of the rate is expm1 of
+    // the error of its logarithm
+    double max_rel_error = 0.;
+    for (int i=0; i<ion_atomic_number; ++i) {
+        for (int j=0; j<ntable-1; ++j) {
+            const double exact = log_rate(i, log_e_min + (j + 0.5) * dlog);
+            if (exact < log_rate_negligible) continue;
+            const amrex::Real* table = h_adk_log_rate_table.data() + 2*(i*ntable + j);
+            // cubic Hermite interpolation at t = 0.5
+            const double interp = 0.5 * (static_cast<double>(table[0]) + table[2])
+                + 0.125 * (static_cast<double>(table[1]) - table[3]);
+            max_rel_error = std::max(max_rel_error, std::abs(std::expm1(interp - exact)));
+        }
+    }
+    if (Hipace::m_verbose >= 1) {
+        amrex::Print() << m_name << ": ADK ionization table with " << ntable
+                       << " points per ion level, max. relative error of the rate "
+                       << max_rel_error << "\n";
+    }
+    if (!(max_rel_error <= m_adk_table_tolerance)) {
+        amrex::Print() << "WARNING: relative interpolation error " << max_rel_error
+                       << " of the ADK ionization table of " << m_name << " is larger than "
+                       << "ionization_table_tolerance = " << m_adk_table_tolerance
+                       << ", the ADK formula is evaluated directly\n";
+        m_adk_table_size = 0;
+        return;
+    }
+
+    m_adk_log_rate_table.resize(2 * ion_atomic_number * ntable);
+    amrex::Gpu::copy(amrex::Gpu::hostToDevice, h_adk_log_rate_table.begin(),
+        h_adk_log_rate_table.end(), m_adk_log_rate_table.begin());
 }
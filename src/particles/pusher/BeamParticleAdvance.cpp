@@ -30,7 +30,12 @@ AdvanceBeamParticlesSlice (
     const int n_subcycles = beam.m_n_subcycles;
     const bool radiation_reaction = beam.m_do_radiation_reaction;
     const amrex::Real time = Hipace::GetInstance().m_physical_time;
-    const amrex::Real dt = Hipace::GetInstance().m_dt / n_subcycles;
+    const amrex::Real dt_step = Hipace::GetInstance().m_dt;
+    const bool adaptive_subcycling = beam.m_adaptive_subcycling;
+    const int n_subcycles_min = beam.m_n_subcycles_min;
+    const int n_subcycles_max = beam.m_n_subcycles_max;
+    const amrex::Real inv_max_phase = 1._rt / beam.m_subcycling_max_phase;
+    unsigned long long * const p_subcycling_stats = beam.m_subcycling_stats.dataPtr();
     const amrex::Real background_density_SI = Hipace::m_background_density_SI;
     const bool normalized_units = Hipace::m_normalized_units;
     const bool spin_tracking = beam.m_do_spin_tracking;
@@ -81,6 +86,7 @@ AdvanceBeamParticlesSlice (
     const amrex::Real y_pos_offset_lev1 = GetPosOffset(1, gm[lev1_idx], slice_fab_lev1.box());
     const amrex::Real y_pos_offset_lev2 = GetPosOffset(1, gm[lev2_idx], slice_fab_lev2.box());
 
+    const CheckDomainBounds lev0_bounds {gm[lev0_idx]};
     const CheckDomainBounds lev1_bounds {gm[lev1_idx]};
     const CheckDomainBounds lev2_bounds {gm[lev2_idx]};
 
@@ -97,6 +103,13 @@ AdvanceBeamParticlesSlice (
     const amrex::Real min_z = gm[0].ProbLo(2) + (slice-gm[0].Domain().smallEnd(2))*gm[0].CellSize(2);
     bool use_external_fields = beam.m_use_external_fields;
     auto external_fields = beam.m_external_fields;
+    if (use_external_fields) {
+        // only re-sampled if the time changed and the fields depend on t
+        beam.m_external_fields_table.Update(external_fields, beam.m_external_fields_parser,
+                                            gm[0], time);
+    }
+    const bool use_external_fields_table = beam.m_external_fields_table.use();
+    const auto external_fields_table = beam.m_external_fields_table.getData();
 
     // Radiation reaction constant
     const amrex::ParticleReal q_over_mc = normalized_units ?
@@ -137,6 +150,64 @@ AdvanceBeamParticlesSlice (
             amrex::Real uz = ptd.rdata(BeamIdx::uz)[ip];
 
             int i = ptd.idata(BeamIdx::nsubcycles)[ip];
+            const int i_start = i;
+
+            int n_sub = n_subcycles;
+            if (adaptive_subcycling) {
+                if (i == 0) {
+                    // Estimate the focusing strength from the gradient of the transverse fields
+                    // on level 0 and resolve the betatron phase advance with enough sub-cycles
+                    const amrex::Real hx = 1._rt / dx_inv_lev0;
+                    const amrex::Real hy = 1._rt / dy_inv_lev0;
+                    n_sub = n_subcycles_max;
+                    if (lev0_bounds.contains(xp - hx, yp - hy) &&
+                        lev0_bounds.contains(xp + hx, yp + hy)) {
+                        amrex::ParticleReal ExmByp_p = 0._rt, EypBxp_p = 0._rt, Ezp_p = 0._rt;
+                        amrex::ParticleReal Bxp_p = 0._rt, Byp_p = 0._rt, Bzp_p = 0._rt;
+                        amrex::ParticleReal ExmByp_m = 0._rt, EypBxp_m = 0._rt, Ezp_m = 0._rt;
+                        amrex::ParticleReal Bxp_m = 0._rt, Byp_m = 0._rt, Bzp_m = 0._rt;
+                        doGatherShapeN<depos_order.value>(xp + hx, yp + hy,
+                            ExmByp_p, EypBxp_p, Ezp_p, Bxp_p, Byp_p, Bzp_p,
+                            slice_arr_lev0, psi_comp, ez_comp, bx_comp, by_comp, bz_comp,
+                            dx_inv_lev0, dy_inv_lev0, x_pos_offset_lev0, y_pos_offset_lev0);
+                        doGatherShapeN<depos_order.value>(xp - hx, yp - hy,
+                            ExmByp_m, EypBxp_m, Ezp_m, Bxp_m, Byp_m, Bzp_m,
+                            slice_arr_lev0, psi_comp, ez_comp, bx_comp, by_comp, bz_comp,
+                            dx_inv_lev0, dy_inv_lev0, x_pos_offset_lev0, y_pos_offset_lev0);
+                        if (c_use_external_fields.value) {
+                            if (use_external_fields_table) {
+                                ApplyTabulatedExternalField(xp + hx, yp + hy, zp, clight,
+                                    ExmByp_p, EypBxp_p, Ezp_p, Bxp_p, Byp_p, Bzp_p,
+                                    external_fields_table);
+                                ApplyTabulatedExternalField(xp - hx, yp - hy, zp, clight,
+                                    ExmByp_m, EypBxp_m, Ezp_m, Bxp_m, Byp_m, Bzp_m,
+                                    external_fields_table);
+                            } else {
+                                ApplyExternalField(xp + hx, yp + hy, zp, time, clight,
+                                    ExmByp_p, EypBxp_p, Ezp_p, Bxp_p, Byp_p, Bzp_p,
+                                    external_fields);
+                                ApplyExternalField(xp - hx, yp - hy, zp, time, clight,
+                                    ExmByp_m, EypBxp_m, Ezp_m, Bxp_m, Byp_m, Bzp_m,
+                                    external_fields);
+                            }
+                        }
+                        const amrex::Real focusing = amrex::max(
+                            std::abs(ExmByp_p - ExmByp_m) * 0.5_rt * dx_inv_lev0,
+                            std::abs(EypBxp_p - EypBxp_m) * 0.5_rt * dy_inv_lev0);
+                        const amrex::Real gamma = std::sqrt(1._rt + (ux*ux + uy*uy + uz*uz)*inv_c2);
+                        // betatron frequency omega_beta^2 = q/m * dF/dx / gamma
+                        const amrex::Real omega_beta =
+                            std::sqrt(std::abs(charge_mass_ratio) * focusing / gamma);
+                        const amrex::Real n_phase = std::ceil(omega_beta * dt_step * inv_max_phase);
+                        n_sub = static_cast<int>(amrex::min(amrex::Real(n_subcycles_max),
+                                                 amrex::max(amrex::Real(n_subcycles_min), n_phase)));
+                    }
+                    ptd.idata(BeamIdx::nsubcycles_total)[ip] = n_sub;
+                } else {
+                    n_sub = ptd.idata(BeamIdx::nsubcycles_total)[ip];
+                }
+            }
+            const amrex::Real dt = dt_step / n_sub;
 
             amrex::RealVect spin {0._rt, 0._rt, 0._rt};
             if (spin_tracking) {
@@ -145,7 +216,7 @@ AdvanceBeamParticlesSlice (
                 spin[2] = ptd.m_runtime_rdata[2][ip];
             }
 
-            for (; i < n_subcycles; i++) {
+            for (; i < n_sub; i++) {
 
                 if (zp < min_z) {
                     // stop pushing particle if it is not on this slice anymore
@@ -194,8 +265,13 @@ AdvanceBeamParticlesSlice (
                     dx_inv, dy_inv, x_pos_offset, y_pos_offset);
 
                 if (c_use_external_fields.value) {
-                    ApplyExternalField(xp, yp, zp, time, clight, ExmByp, EypBxp, Ezp, Bxp, Byp, Bzp,
-                        external_fields);
+                    if (use_external_fields_table) {
+                        ApplyTabulatedExternalField(xp, yp, zp, clight,
+                            ExmByp, EypBxp, Ezp, Bxp, Byp, Bzp, external_fields_table);
+                    } else {
+                        ApplyExternalField(xp, yp, zp, time, clight,
+                            ExmByp, EypBxp, Ezp, Bxp, Byp, Bzp, external_fields);
+                    }
                 }
 
                 // use intermediate fields to calculate next (n+1) transverse momenta
@@ -323,6 +399,11 @@ AdvanceBeamParticlesSlice (
             ptd.pos(1, ip) = yp;
             ptd.pos(2, ip) = zp;
             ptd.idata(BeamIdx::nsubcycles)[ip] = i;
+            if (adaptive_subcycling) {
+                amrex::Gpu::Atomic::Add(p_subcycling_stats, (unsigned long long)(i - i_start));
+                // count every particle once, on the slice where it completes the time step
+                if (i == n_sub) amrex::Gpu::Atomic::Add(p_subcycling_stats + 1, 1ull);
+            }
             ptd.rdata(BeamIdx::ux)[ip] = ux;
             ptd.rdata(BeamIdx::uy)[ip] = uy;
             ptd.rdata(BeamIdx::uz)[ip] = uz;
@@ -0,0 +1,119 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ExternalFields.H"
+#include "utils/HipaceProfilerWrapper.H"
+#include "utils/Parser.H"
+
+#include <AMReX_Reduce.H>
+
+void
+ExternalFieldTable::ReadParameters (const amrex::ParmParse& pp, const amrex::ParmParse& pp_alt)
+{
+    m_enabled = queryWithParserAlt(pp, "external_fields_table_size", m_size, pp_alt);
+    queryWithParserAlt(pp, "external_fields_table_tolerance", m_tolerance, pp_alt);
+    if (m_enabled) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_size[0] >= 2 && m_size[1] >= 2 && m_size[2] >= 2,
+            "external_fields_table_size must be at least 2 in every direction");
+    }
+}
+
+void
+ExternalFieldTable::Update (const amrex::GpuArray<amrex::ParserExecutor<4>, 6>& funcs,
+                            const amrex::Array<amrex::Parser, 6>& parsers,
+                            const amrex::Geometry& geom, amrex::Real time)
+{
+    if (!m_enabled) return;
+    if (m_is_sampled && (!m_depends_on_time || time == m_time)) return;
+
+    HIPACE_PROFILE("ExternalFieldTable::Update()");
+    using namespace amrex::literals;
+
+    const bool is_first_sample = !m_is_sampled;
+    if (is_first_sample) {
+        for (const auto& parser : parsers) {
+            m_depends_on_time = m_depends_on_time || parser.symbols().count("t") != 0;
+        }
+    }
+
+    const int nx = m_size[0];
+    const int ny = m_size[1];
+    const int nz = m_size[2];
+    const amrex::Long npoints = amrex::Long(nx) * ny * nz;
+    m_data.resize(6 * npoints);
+
+    amrex::Real dx[3];
+    for (int d = 0; d < 3; ++d) {
+        dx[d] = (geom.ProbHi(d) - geom.ProbLo(d)) / (m_size[d] - 1);
+        m_table.m_n[d] = m_size[d];
+        m_table.m_lo[d] = geom.ProbLo(d);
+        m_table.m_inv_dx[d] = 1._rt / dx[d];
+    }
+    m_table.m_data = m_data.dataPtr();
+
+    const amrex::Real x_lo = m_table.m_lo[0];
+    const amrex::Real y_lo = m_table.m_lo[1];
+    const amrex::Real z_lo = m_table.m_lo[2];
+    const amrex::Real dx0 = dx[0];
+    const amrex::Real dx1 = dx[1];
+    const amrex::Real dx2 = dx[2];
+    const auto f = funcs;
+    amrex::Real * const data = m_data.dataPtr();
+
+    // sample all six fields on the grid nodes
+    amrex::ParallelFor(amrex::Box(amrex::IntVect(0, 0, 0), amrex::IntVect(nx-1, ny-1, nz-1)),
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            const amrex::Real x = x_lo + i * dx0;
+            const amrex::Real y = y_lo + j * dx1;
+            const amrex::Real z = z_lo + k * dx2;
+            const amrex::Long idx = i + j * amrex::Long(nx) + k * amrex::Long(nx) * ny;
+            for (int comp = 0; comp < 6; ++comp) {
+                data[comp * npoints + idx] = f[comp](x, y, z, time);
+            }
+        });
+
+    // compare the interpolation with the direct evaluation at the cell centers,
+    // E and B are checked separately as their magnitude differs by c in SI units
+    const auto table = m_table;
+    amrex::ReduceOps<amrex::ReduceOpMax, amrex::ReduceOpMax,
+                     amrex::ReduceOpMax, amrex::ReduceOpMax> reduce_op;
+    amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    reduce_op.eval(amrex::Box(amrex::IntVect(0, 0, 0), amrex::IntVect(nx-2, ny-2, nz-2)),
+        reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) -> ReduceTuple
+        {
+            const amrex::Real x = x_lo + (i + 0.5_rt) * dx0;
+            const amrex::Real y = y_lo + (j + 0.5_rt) * dx1;
+            const amrex::Real z = z_lo + (k + 0.5_rt) * dx2;
+            amrex::Real interp[6];
+            table(x, y, z, interp);
+            amrex::Real err[2] = {0._rt, 0._rt};
+            amrex::Real val[2] = {0._rt, 0._rt};
+            for (int comp = 0; comp < 6; ++comp) {
+                const amrex::Real direct = f[comp](x, y, z, time);
+                err[comp / 3] = amrex::max(err[comp / 3], std::abs(interp[comp] - direct));
+                val[comp / 3] = amrex::max(val[comp / 3], std::abs(direct));
+            }
+            return {err[0], val[0], err[1], val[1]};
+        });
+    auto [err_E, val_E, err_B, val_B] = reduce_data.value();
+    const amrex::Real rel_err = amrex::max(val_E > 0._rt ? err_E / val_E : 0._rt,
+                                           val_B > 0._rt ? err_B / val_B : 0._rt);
+
+    const bool was_accurate = m_is_accurate;
+    m_is_accurate = rel_err <= m_tolerance;
+    if (!m_is_accurate && (was_accurate || is_first_sample)) {
+        amrex::Print() << "WARNING: relative interpolation error " << rel_err
+                       << " of the external field table is larger than "
+                       << "external_fields_table_tolerance = " << m_tolerance
+                       << ", the external fields are evaluated directly\n";
+    }
+
+    m_is_sampled = true;
+    m_time = time;
+}
@@ -8,6 +8,7 @@
 #include "PlasmaParticleAdvance.H"
 
 #include "particles/plasma/PlasmaParticleContainer.H"
+#include "particles/deposition/PlasmaDepositCurrent.H"
 #include "particles/particles_utils/FieldGather.H"
 #include "PushPlasmaParticles.H"
 #include "fields/Fields.H"
@@ -27,20 +28,23 @@ template struct PlasmaMomentumDerivative<amrex::Real>;
 template struct PlasmaMomentumDerivative<DualNumber>;
 
 void
-AdvancePlasmaParticles (PlasmaParticleContainer& plasma, const Fields & fields,
+AdvancePlasmaParticles (PlasmaParticleContainer& plasma, Fields & fields,
                         amrex::Vector<amrex::Geometry> const& gm, const bool temp_slice,
-                        int const lev)
+                        int const lev, const bool deposit_next)
 {
     HIPACE_PROFILE("AdvancePlasmaParticles()");
     using namespace amrex::literals;
 
     const PhysConst phys_const = get_phys_const();
 
+    // the particles move, so the tile binning of the incremental sort is outdated
+    plasma.m_tile_sorter.invalidate();
+
     // Loop over particle boxes
     for (PlasmaParticleIterator pti(plasma); pti.isValid(); ++pti)
     {
         // Extract field array from FabArray
-        const amrex::FArrayBox& slice_fab = fields.getSlices(lev)[pti];
+        amrex::FArrayBox& slice_fab = fields.getSlices(lev)[pti];
         Array3<const amrex::Real> const slice_arr = slice_fab.const_array();
         const int psi_comp = Comps[WhichSlice::This]["Psi"];
         const int ez_comp = Comps[WhichSlice::This]["Ez"];
@@ -79,17 +83,36 @@ AdvancePlasmaParticles (PlasmaParticleContainer& plasma, const Fields & fields,
         const amrex::Real clight_inv = 1._rt/phys_const.c;
         const amrex::Real charge_mass_clight_ratio = plasma.m_charge/(plasma.m_mass * phys_const.c);
 
+        // Components of the next slice for the fused deposition.
+        // Do not access them if they are not deposited, they might not be allocated.
+        Array3<amrex::Real> const next_arr = slice_fab.array();
+        amrex::GpuArray<int, 6> next_idx {-1, -1, -1, -1, -1, -1};
+        int next_aabs_comp = -1;
+        int n_qsa_violation = 0;
+        amrex::Gpu::DeviceScalar<int> gpu_n_qsa_violation(n_qsa_violation);
+        PlasmaDepositParams depos_params {};
+        if (deposit_next) {
+            next_idx = {Comps[WhichSlice::Next]["jx"], Comps[WhichSlice::Next]["jy"], -1,
+                        Hipace::m_deposit_rho ? Comps[WhichSlice::Next]["rho"] : -1,
+                        Comps[WhichSlice::Next]["chi"], Comps[WhichSlice::Next]["rhomjz"]};
+            next_aabs_comp = Hipace::m_use_laser ? Comps[WhichSlice::Next]["aabs"] : -1;
+            depos_params = GetPlasmaDepositParams(plasma, WhichSlice::Next, gm, lev,
+                slice_fab.box(), gpu_n_qsa_violation.dataPtr());
+        }
+
         // Use OMP ParallelFor to use multiple threads when running on CPU
         omp::ParallelFor(
             amrex::TypeList<
                 amrex::CompileTimeOptions<0, 1, 2, 3>,
+                amrex::CompileTimeOptions<false, true>,
                 amrex::CompileTimeOptions<false, true>
             >{}, {
                 Hipace::m_depos_order_xy,
-                Hipace::m_use_laser
+                Hipace::m_use_laser,
+                deposit_next
             },
             int(pti.numParticles()), // int ParallelFor is 3-5% faster than amrex::Long version
-            [=] AMREX_GPU_DEVICE (int ip, auto depos_order, auto use_laser) {
+            [=] AMREX_GPU_DEVICE (int ip, auto depos_order, auto use_laser, auto fused_depos) {
                 // only push plasma particles on their according MR level
                 if (!ptd.id(ip).is_valid() || ptd.cpu(ip) != lev) return;
 
@@ -269,8 +292,27 @@ AdvancePlasmaParticles (PlasmaParticleContainer& plasma, const Fields & fields,
                     ptd.rdata(PlasmaIdx::psi)[ip] = psi;
 #endif
                 } // loop over subcycles
+
+                if constexpr (fused_depos.value) {
+                    // deposit the current of the pushed particle to the next slice,
+                    // OMP threads can deposit into the same cell so host atomics are needed
+                    if (can_ionize) {
+                        DepositPlasmaParticle<depos_order.value, true, use_laser.value, true>(
+                            ip, ptd, next_arr, next_aabs_comp, next_idx, depos_params);
+                    } else {
+                        DepositPlasmaParticle<depos_order.value, false, use_laser.value, true>(
+                            ip, ptd, next_arr, next_aabs_comp, next_idx, depos_params);
+                    }
+                }
             });
 
+        if (deposit_next) {
+            n_qsa_violation = gpu_n_qsa_violation.dataValue();
+            if (n_qsa_violation > 0 && (Hipace::m_verbose >= 3))
+                amrex::Print()<< "number of QSA violating particles on the next slice: "
+                              << n_qsa_violation << "\n";
+        }
+
 #ifdef HIPACE_USE_AB5_PUSH
         if (!temp_slice) {
             auto& rd = pti.GetStructOfArrays().GetRealData();
@@ -8,6 +8,7 @@
 #include "BoxSort.H"
 #include "particles/beam/BeamParticleContainer.H"
 #include "utils/HipaceProfilerWrapper.H"
+#include "utils/ScratchArena.H"
 
 #include <AMReX_ParticleTransformation.H>
 
@@ -24,8 +25,9 @@ void BoxSorter::sortParticlesByBox (const amrex::Real * z_array, const index_typ
     m_box_offsets_cpu.resize(num_boxes+1);
     m_box_permutations.resize(num_particles);
 
-    amrex::Gpu::DeviceVector<index_type> box_counts (num_boxes+1, 0);
-    amrex::Gpu::DeviceVector<index_type> box_offsets (num_boxes+1, 0);
+    ScratchScope scratch_scope;
+    auto box_counts = MakeScratchVector<index_type>(num_boxes+1, 0);
+    auto box_offsets = MakeScratchVector<index_type>(num_boxes+1, 0);
 
     auto p_box_counts = box_counts.dataPtr();
     auto p_permutations = m_box_permutations.dataPtr();
@@ -0,0 +1,196 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "IncrementalSort.H"
+#include "particles/plasma/PlasmaParticleContainer.H"
+#include "particles/particles_utils/ShapeFactors.H"
+#include "Hipace.H"
+#include "utils/HipaceProfilerWrapper.H"
+#include "utils/ScratchArena.H"
+
+#include <AMReX_Scan.H>
+
+#include <cstdint>
+
+namespace
+{
+    /** \brief Index of the first element in the sorted array arr of size n that is >= val */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    int lowerBound (const int* arr, int n, int val) noexcept
+    {
+        int lo = 0;
+        int hi = n;
+        while (lo < hi) {
+            const int mid = lo + (hi - lo) / 2;
+            if (arr[mid] < val) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    /** \brief Move one particle component from the places in src to the places in dst
+     *
+     * \param[in,out] data particle component
+     * \param[in] tmp temporary array of size num_moved
+     * \param[in] src old indexes of the moved particles
+     * \param[in] dst new indexes of the moved particles
+     * \param[in] num_moved number of moved particles
+     */
+    template<class T>
+    void moveParticleData (T* data, T* tmp, const int* src, const int* dst, int num_moved)
+    {
+        amrex::ParallelFor(num_moved,
+            [=] AMREX_GPU_DEVICE (int m) {
+                tmp[m] = data[src[m]];
+            });
+        amrex::ParallelFor(num_moved,
+            [=] AMREX_GPU_DEVICE (int m) {
+                data[dst[m]] = tmp[m];
+            });
+    }
+}
+
+void
+IncrementalTileSorter::sortParticlesByTile (PlasmaParticleContainer& plasma,
+                                            const amrex::Box& box, const amrex::Geometry& geom)
+{
+    HIPACE_PROFILE("IncrementalTileSorter::sortParticlesByTile()");
+
+    const int tile_size = Hipace::m_tile_size;
+    const int lo_x = box.smallEnd(0);
+    const int lo_y = box.smallEnd(1);
+    const int ntile_x = (box.length(0) + tile_size - 1) / tile_size;
+    const int ntile_y = (box.length(1) + tile_size - 1) / tile_size;
+    const int ntiles = ntile_x * ntile_y;
+
+    // Offset for converting positions to indexes
+    const amrex::Real x_pos_offset = GetPosOffset(0, geom, box);
+    const amrex::Real y_pos_offset = GetPosOffset(1, geom, box);
+    const amrex::Real dx_inv = geom.InvCellSize(0);
+    const amrex::Real dy_inv = geom.InvCellSize(1);
+
+    int count = 0; // number of boxes
+    for (PlasmaParticleIterator pti(plasma); pti.isValid(); ++pti) {
+        count += 1;
+
+        const int num_particles = int(pti.numParticles());
+        const auto ptd = pti.GetParticleTile().getParticleTileData();
+
+        ScratchScope scratch_scope;
+        auto tile_idx = MakeScratchVector<int>(num_particles);
+        auto tile_counts = MakeScratchVector<int>(ntiles + 2, 0);
+        m_tile_offsets.resize(ntiles + 2);
+        int * const p_tile_idx = tile_idx.dataPtr();
+        int * const p_tile_counts = tile_counts.dataPtr();
+        int * const p_tile_offsets = m_tile_offsets.dataPtr();
+
+        // compute the new tile of every particle, invalid particles go into the last tile
+        amrex::ParallelFor(
+            amrex::TypeList<amrex::CompileTimeOptions<0, 1, 2, 3>>{},
+            {Hipace::m_depos_order_xy},
+            num_particles,
+            [=] AMREX_GPU_DEVICE (int ip, auto depos_order) {
+                int tile_id = ntiles;
+                if (ptd.id(ip).is_valid()) {
+                    // lowest cell that the particle deposits into, same as in DepositCurrent
+                    const amrex::Real xmid = (ptd.pos(0, ip) - x_pos_offset) * dx_inv;
+                    const amrex::Real ymid = (ptd.pos(1, ip) - y_pos_offset) * dy_inv;
+
+                    auto [shape_x, cell_x] =
+                        compute_single_shape_factor<false, depos_order>(xmid, 0);
+                    auto [shape_y, cell_y] =
+                        compute_single_shape_factor<false, depos_order>(ymid, 0);
+
+                    tile_id = ((cell_x - lo_x) / tile_size) * ntile_y + (cell_y - lo_y) / tile_size;
+                }
+                p_tile_idx[ip] = tile_id;
+                amrex::Gpu::Atomic::Add(p_tile_counts + tile_id, 1);
+            });
+
+        // counting sort: range of every tile in the sorted particle arrays
+        amrex::Scan::ExclusiveSum(ntiles + 2, p_tile_counts, p_tile_offsets);
+
+        // particles that are already in the range of their tile stay where they are,
+        // the places of all other particles are free and get filled with exactly those
+        auto move_src = MakeScratchVector<int>(num_particles);
+        int * const p_move_src = move_src.dataPtr();
+        const int num_moved = amrex::Scan::PrefixSum<int>(num_particles,
+            [=] AMREX_GPU_DEVICE (int ip) -> int {
+                const int t = p_tile_idx[ip];
+                return (ip < p_tile_offsets[t] || ip >= p_tile_offsets[t+1]) ? 1 : 0;
+            },
+            [=] AMREX_GPU_DEVICE (int ip, int s) {
+                const int t = p_tile_idx[ip];
+                if (ip < p_tile_offsets[t] || ip >= p_tile_offsets[t+1]) {
+                    p_move_src[s] = ip;
+                }
+            },
+            amrex::Scan::Type::exclusive, amrex::Scan::retSum);
+
+        m_num_moved = num_moved;
+
+        if (num_moved > 0) {
+            // first free place of every tile, move_src is sorted so it is also the list of
+            // free places sorted by tile
+            ScratchScope scratch_scope_moved;
+            auto free_start = MakeScratchVector<int>(ntiles + 1);
+            auto free_fill = MakeScratchVector<int>(ntiles + 1, 0);
+            auto move_dst = MakeScratchVector<int>(num_moved);
+            int * const p_free_start = free_start.dataPtr();
+            int * const p_free_fill = free_fill.dataPtr();
+            int * const p_move_dst = move_dst.dataPtr();
+
+            amrex::ParallelFor(ntiles + 1,
+                [=] AMREX_GPU_DEVICE (int t) {
+                    p_free_start[t] = lowerBound(p_move_src, num_moved, p_tile_offsets[t]);
+                });
+
+            amrex::ParallelFor(num_moved,
+                [=] AMREX_GPU_DEVICE (int m) {
+                    const int t = p_tile_idx[p_move_src[m]];
+                    const int rank = amrex::Gpu::Atomic::Add(p_free_fill + t, 1);
+                    p_move_dst[m] = p_move_src[p_free_start[t] + rank];
+                });
+
+            // only move the particles that changed places
+            auto& soa = pti.GetStructOfArrays();
+            auto tmp_real = MakeScratchVector<amrex::ParticleReal>(num_moved);
+            auto tmp_int = MakeScratchVector<int>(num_moved);
+            auto tmp_idcpu = MakeScratchVector<std::uint64_t>(num_moved);
+
+            for (int comp = 0; comp < soa.NumRealComps(); ++comp) {
+                moveParticleData(soa.GetRealData(comp).dataPtr(), tmp_real.dataPtr(),
+                                 p_move_src, p_move_dst, num_moved);
+            }
+            for (int comp = 0; comp < soa.NumIntComps(); ++comp) {
+                moveParticleData(soa.GetIntData(comp).dataPtr(), tmp_int.dataPtr(),
+                                 p_move_src, p_move_dst, num_moved);
+            }
+            moveParticleData(soa.GetIdCPUData().dataPtr(), tmp_idcpu.dataPtr(),
+                             p_move_src, p_move_dst, num_moved);
+        }
+
+        m_box = box;
+        m_num_particles = num_particles;
+        m_tile_size = tile_size;
+        m_depos_order = Hipace::m_depos_order_xy;
+        m_is_valid = true;
+    }
+    AMREX_ALWAYS_ASSERT(count <= 1);
+}
+
+const int*
+IncrementalTileSorter::tileOffsetsPtr (int num_particles, const amrex::Box& box) const
+{
+    if (m_is_valid && num_particles == m_num_particles && box == m_box &&
+        m_tile_size == Hipace::m_tile_size && m_depos_order == Hipace::m_depos_order_xy) {
+        return m_tile_offsets.dataPtr();
+    }
+    return nullptr;
+}
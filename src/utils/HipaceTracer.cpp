@@ -0,0 +1,103 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "HipaceTracer.H"
+#include "Parser.H"
+
+#include <AMReX_OpenMP.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParmParse.H>
+
+#include <fstream>
+#include <iomanip>
+
+void
+HipaceTracer::Initialize ()
+{
+    amrex::ParmParse pph("hipace");
+    queryWithParser(pph, "trace_file", m_file_name);
+    m_enabled = !m_file_name.empty();
+    m_main_thread = std::this_thread::get_id();
+    if (m_enabled) {
+        // align the time origin of all ranks so the pipeline can be compared between them
+        amrex::ParallelDescriptor::Barrier();
+        m_time_origin = amrex::ParallelDescriptor::second();
+    }
+}
+
+bool
+HipaceTracer::IsRecordingThread ()
+{
+    // events from inside OpenMP parallel regions or from std::threads (e.g. asynchronous IO)
+    // would not be properly nested. OpenMP thread 0 of a std::thread is not the main thread.
+    return std::this_thread::get_id() == m_main_thread && amrex::OpenMP::get_thread_num() == 0;
+}
+
+void
+HipaceTracer::Begin (const char* name)
+{
+    if (!IsRecordingThread()) return;
+    m_events.push_back(Event{name, 'B', amrex::ParallelDescriptor::second() - m_time_origin,
+                             m_slice, m_step, 0.});
+}
+
+void
+HipaceTracer::End (const char* name)
+{
+    if (!IsRecordingThread()) return;
+    m_events.push_back(Event{name, 'E', amrex::ParallelDescriptor::second() - m_time_origin,
+                             m_slice, m_step, 0.});
+}
+
+void
+HipaceTracer::Counter (const char* name, double value)
+{
+    if (!m_enabled || !IsRecordingThread()) return;
+    m_events.push_back(Event{name, 'C', amrex::ParallelDescriptor::second() - m_time_origin,
+                             m_slice, m_step, value});
+}
+
+void
+HipaceTracer::Finalize ()
+{
+    if (!m_enabled) return;
+    m_enabled = false;
+
+    const int rank = amrex::ParallelDescriptor::MyProc();
+    const int nprocs = amrex::ParallelDescriptor::NProcs();
+
+    // ranks append their events one after another to the same file
+    for (int r = 0; r < nprocs; ++r) {
+        if (r == rank) {
+            std::ofstream ofs(m_file_name, r == 0 ? std::ios::trunc : std::ios::app);
+            ofs << std::setprecision(15);
+            if (r == 0) {
+                ofs << "{\"traceEvents\":[\n";
+            } else {
+                ofs << ",\n";
+            }
+            ofs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+                << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+            for (const auto& ev : m_events) {
+                // Chrome trace timestamps are in microseconds
+                ofs << ",\n{\"name\":\"" << ev.name << "\",\"ph\":\"" << ev.phase
+                    << "\",\"ts\":" << ev.time * 1.e6 << ",\"pid\":" << rank << ",\"tid\":0";
+                if (ev.phase == 'B') {
+                    ofs << ",\"args\":{\"slice\":" << ev.slice << ",\"step\":" << ev.step << "}";
+                } else if (ev.phase == 'C') {
+                    ofs << ",\"args\":{\"value\":" << ev.value << "}";
+                }
+                ofs << "}";
+            }
+            if (r == nprocs - 1) {
+                ofs << "\n],\"displayTimeUnit\":\"ms\"}\n";
+            }
+        }
+        amrex::ParallelDescriptor::Barrier();
+    }
+    m_events.clear();
+    m_events.shrink_to_fit();
+}
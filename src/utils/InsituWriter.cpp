@@ -0,0 +1,141 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "InsituWriter.H"
+#include "utils/HipaceProfilerWrapper.H"
+#include "utils/Parser.H"
+#ifdef HIPACE_USE_OPENPMD
+#   include <openPMD/auxiliary/Filesystem.hpp>
+#endif
+
+#include <AMReX_ParmParse.H>
+
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+InsituWriter::InsituWriter ()
+{
+    amrex::ParmParse pp("hipace");
+    queryWithParser(pp, "insitu_buffer_steps", m_buffer_steps);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_buffer_steps >= 1,
+        "hipace.insitu_buffer_steps must be at least 1");
+}
+
+InsituWriter::~InsituWriter ()
+{
+    Flush();
+    WaitForFlush();
+}
+
+void
+InsituWriter::Write (const std::string& prefix, const std::string& name, int step,
+                     const amrex::Vector<insitu_utils::DataNode>& all_data)
+{
+    HIPACE_PROFILE("InsituWriter::Write()");
+
+    // zero pad the rank number;
+    std::string::size_type n_zeros = 4;
+    std::string rank_num = std::to_string(amrex::ParallelDescriptor::MyProc());
+    std::string pad_rank_num = std::string(n_zeros-std::min(rank_num.size(), n_zeros),'0')+rank_num;
+
+    const std::string file_name = prefix + "/reduced_" + name + "." + pad_rank_num;
+
+    // pointers to the files stay valid when new ones are added while a flush is in progress
+    auto& file = m_files[file_name];
+    if (!file) {
+#ifdef HIPACE_USE_OPENPMD
+        // create subdirectory
+        openPMD::auxiliary::create_directories(prefix);
+#endif
+        file = std::make_unique<File>();
+        file->m_ofs.open(file_name + ".txt",
+            std::ofstream::out | std::ofstream::app | std::ofstream::binary);
+        file->m_index.open(file_name + ".index", std::ofstream::out | std::ofstream::app);
+        // assert no file errors
+#ifdef HIPACE_USE_OPENPMD
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(file->m_ofs && file->m_index,
+            "Error while opening insitu diagnostics file " + file_name);
+#else
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(file->m_ofs && file->m_index,
+            "Error while opening insitu diagnostics file " + file_name +
+            ". Maybe the specified subdirectory does not exist");
+#endif
+        // continue after the records of a previous run
+        file->m_ofs.seekp(0, std::ios::end);
+        file->m_size = static_cast<std::uint64_t>(file->m_ofs.tellp());
+    }
+
+    std::ostringstream oss;
+    if (file->m_size == 0) {
+        // write JSON header containing a NumPy structured datatype
+        insitu_utils::write_header(all_data, oss);
+    }
+    const std::uint64_t record_offset = file->m_size + static_cast<std::uint64_t>(oss.tellp());
+
+    // write binary data according to datatype in header
+    insitu_utils::write_data(all_data, oss);
+
+    const std::string record = oss.str();
+    file->m_buffer += record;
+    file->m_size += record.size();
+    file->m_index_buffer += std::to_string(step) + " " + std::to_string(record_offset) + "\n";
+    m_step_has_output = true;
+}
+
+void
+InsituWriter::EndStep ()
+{
+    if (!m_step_has_output) return;
+    m_step_has_output = false;
+    ++m_num_buffered_steps;
+    if (m_num_buffered_steps >= m_buffer_steps) {
+        Flush();
+    }
+}
+
+void
+InsituWriter::Flush ()
+{
+    HIPACE_PROFILE("InsituWriter::Flush()");
+
+    // only one background write at a time, so the records stay in order
+    WaitForFlush();
+    m_num_buffered_steps = 0;
+
+    std::vector<std::tuple<File*, std::string, std::string>> pending;
+    for (auto& [file_name, file] : m_files) {
+        if (file->m_buffer.empty()) continue;
+        pending.emplace_back(file.get(), std::move(file->m_buffer),
+                             std::move(file->m_index_buffer));
+        file->m_buffer.clear();
+        file->m_index_buffer.clear();
+    }
+    if (pending.empty()) return;
+
+    m_flush = std::async(std::launch::async,
+        [pending = std::move(pending)] () {
+            bool ok = true;
+            for (const auto& [file, buffer, index] : pending) {
+                file->m_ofs.write(buffer.data(), buffer.size());
+                file->m_ofs.flush();
+                file->m_index << index;
+                file->m_index.flush();
+                ok = ok && file->m_ofs && file->m_index;
+            }
+            return ok;
+        });
+}
+
+void
+InsituWriter::WaitForFlush ()
+{
+    if (m_flush.valid()) {
+        HIPACE_PROFILE("InsituWriter::WaitForFlush()");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_flush.get(), "Error while writing insitu diagnostics");
+    }
+}
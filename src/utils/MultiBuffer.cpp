@@ -10,13 +10,18 @@
 #include "HipaceProfilerWrapper.H"
 #include "Parser.H"
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
 
 std::size_t MultiBuffer::get_metadata_size () {
     // 0: buffer size
     // 1: number of particles for beam 0
     // 2: number of particles for beam 1
     // ...
-    return 1 + m_nbeams;
+    // 1 + m_nbeams: uncompressed buffer size if compressed, otherwise 0
+    return 2 + m_nbeams;
 }
 
 std::size_t* MultiBuffer::get_metadata_location (int slice) {
@@ -84,6 +89,19 @@ void MultiBuffer::initialize (int nslices, MultiBeam& beams, MultiLaser& laser)
         m_async_memcpy = false;
     }
 
+    queryWithParser(pp, "compression", m_compression);
+    queryWithParser(pp, "compression_momentum_bits", m_compression_momentum_bits);
+    if (m_compression) {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!m_buffer_on_gpu,
+            "comms_buffer.compression requires comms_buffer.on_gpu = 0");
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_compression_momentum_bits < 0 ||
+            m_compression_momentum_bits < std::numeric_limits<amrex::ParticleReal>::digits,
+            "comms_buffer.compression_momentum_bits must be smaller than the number of mantissa"
+            " bits of amrex::ParticleReal, or negative for lossless compression");
+        // the buffer has to be on the CPU before it is compressed
+        m_async_memcpy = false;
+    }
+
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
         ((double(m_max_trailing_slices) * n_ranks) > nslices)
         || (Hipace::m_max_step < amrex::ParallelDescriptor::NProcs()),
@@ -106,7 +124,7 @@ void MultiBuffer::initialize (int nslices, MultiBeam& beams, MultiLaser& laser)
 
             for (int rcomp = 0; rcomp < beam.numRealComponents(); ++rcomp) {
                 if (beam.communicateRealComponent(rcomp)) {
-                    size_estimate += num_particles * sizeof(amrex::Real);
+                    size_estimate += num_particles * sizeof(amrex::ParticleReal);
                 }
             }
 
@@ -284,6 +302,18 @@ MultiBuffer::~MultiBuffer () {
 #endif
 }
 
+void MultiBuffer::wait_request (MPI_Request& request) {
+#ifdef AMREX_USE_MPI
+    HIPACE_PROFILE("MultiBuffer::MPI_Wait()");
+    const double start_time = amrex::second();
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    m_mpi_wait_time += amrex::second() - start_time;
+    HipaceTracer::Counter("MultiBuffer MPI wait time [s]", m_mpi_wait_time);
+#else
+    amrex::ignore_unused(request);
+#endif
+}
+
 void MultiBuffer::make_progress (int slice, bool is_blocking, int current_slice) {
     const bool is_first_slice_with_recv_data =
         m_async_data_slice[comm_progress::receive_started] == slice;
@@ -340,7 +370,7 @@ void MultiBuffer::make_progress (int slice, bool is_blocking, int current_slice)
 
     if (m_datanodes[slice].m_metadata_progress == comm_progress::send_started) {
         if (is_blocking_send) {
-            MPI_Wait(&(m_datanodes[slice].m_metadata_request), MPI_STATUS_IGNORE);
+            wait_request(m_datanodes[slice].m_metadata_request);
             m_datanodes[slice].m_metadata_progress = comm_progress::sent;
         } else {
             int is_complete = false;
@@ -365,7 +395,7 @@ void MultiBuffer::make_progress (int slice, bool is_blocking, int current_slice)
 
     if (m_datanodes[slice].m_metadata_progress == comm_progress::receive_started) {
         if (is_blocking_recv) {
-            MPI_Wait(&(m_datanodes[slice].m_metadata_request), MPI_STATUS_IGNORE);
+            wait_request(m_datanodes[slice].m_metadata_request);
             m_datanodes[slice].m_metadata_progress = comm_progress::received;
         } else {
             int is_complete = false;
@@ -378,7 +408,7 @@ void MultiBuffer::make_progress (int slice, bool is_blocking, int current_slice)
 
     if (m_datanodes[slice].m_progress == comm_progress::send_started) {
         if (is_blocking_send) {
-            MPI_Wait(&(m_datanodes[slice].m_request), MPI_STATUS_IGNORE);
+            wait_request(m_datanodes[slice].m_request);
             free_buffer(slice);
             m_datanodes[slice].m_progress = comm_progress::sent;
         } else {
@@ -422,7 +452,7 @@ void MultiBuffer::make_progress (int slice, bool is_blocking, int current_slice)
 
     if (m_datanodes[slice].m_progress == comm_progress::receive_started) {
         if (is_blocking_recv) {
-            MPI_Wait(&(m_datanodes[slice].m_request), MPI_STATUS_IGNORE);
+            wait_request(m_datanodes[slice].m_request);
             m_datanodes[slice].m_progress = comm_progress::received;
         } else {
             int is_complete = false;
@@ -480,6 +510,7 @@ void MultiBuffer::get_data (int slice, MultiBeam& beams, MultiLaser& laser, int
         } else {
             make_progress(slice, true, slice);
             if (m_datanodes[slice].m_buffer_size != 0) {
+                decompress_buffer(slice);
                 unpack_data(slice, beams, laser, beam_slice);
                 free_buffer(slice);
             }
@@ -528,6 +559,13 @@ void MultiBuffer::put_data (int slice, MultiBeam& beams, MultiLaser& laser, int
             if (m_datanodes[slice].m_buffer_size != 0) {
                 allocate_buffer(slice);
                 pack_data(slice, beams, laser, beam_slice);
+                if (m_compression && !m_is_serial) {
+                    // the metadata is only sent in make_progress, so it can still be updated
+                    if (m_compression_momentum_bits >= 0) {
+                        quantize_momenta(slice, beams, laser);
+                    }
+                    compress_buffer(slice);
+                }
             }
             m_datanodes[slice].m_progress = comm_progress::ready_to_send;
         }
@@ -662,6 +700,8 @@ void MultiBuffer::write_metadata (int slice, MultiBeam& beams, MultiLaser& laser
     // write total buffer size
     get_metadata_location(slice)[0] = (offset+sizeof(storage_type)-1) / sizeof(storage_type);
     m_datanodes[slice].m_buffer_size = get_metadata_location(slice)[0];
+    // buffer is not compressed (yet)
+    get_metadata_location(slice)[m_nbeams + 1] = 0;
     // MPI uses int as index type so check it wont overflow,
     // we use a 64 byte storage type for this reason
     AMREX_ALWAYS_ASSERT(get_metadata_location(slice)[0] < std::numeric_limits<int>::max());
@@ -693,7 +733,7 @@ std::size_t MultiBuffer::get_buffer_offset (int slice, offset_type type, MultiBe
                 if (type == offset_type::beam_real && ibeam == b && rcomp == comp) {
                     return offset;
                 }
-                offset += num_particles_round_up * sizeof(amrex::Real);
+                offset += num_particles_round_up * sizeof(amrex::ParticleReal);
             }
         }
 
@@ -803,6 +843,158 @@ void MultiBuffer::async_memcpy_from_buffer_finish () {
     amrex::Gpu::Device::resetStreamIndex();
 }
 
+void MultiBuffer::quantize_momenta (int slice, MultiBeam& beams, MultiLaser& laser) {
+    HIPACE_PROFILE("MultiBuffer::quantize_momenta()");
+    // beam momenta are stored as amrex::ParticleReal, which may differ from amrex::Real
+    using real_type = std::remove_pointer_t<decltype(
+        std::declval<BeamTile&>().GetStructOfArrays().GetRealData(0).dataPtr())>;
+    static_assert(std::is_same_v<real_type, amrex::ParticleReal>,
+                  "beam real components are expected to be amrex::ParticleReal");
+    using uint_type = std::conditional_t<sizeof(amrex::ParticleReal) == 8,
+                                         std::uint64_t, std::uint32_t>;
+    static_assert(sizeof(uint_type) == sizeof(real_type),
+                  "bit pattern type must match the beam buffer element type");
+    // number of mantissa bits that are rounded away, excluding the implicit leading bit
+    const int drop_bits = std::numeric_limits<amrex::ParticleReal>::digits - 1
+                          - m_compression_momentum_bits;
+    if (drop_bits <= 0) return;
+    const uint_type mask = ~((uint_type(1) << drop_bits) - 1);
+    const uint_type half = uint_type(1) << (drop_bits - 1);
+
+    for (int b = 0; b < m_nbeams; ++b) {
+        auto& beam = beams.getBeam(b);
+        const std::size_t num_particles = get_metadata_location(slice)[b + 1];
+        for (int rcomp : {BeamIdx::ux, BeamIdx::uy, BeamIdx::uz}) {
+            if (!beam.communicateRealComponent(rcomp)) continue;
+            char* ptr = m_datanodes[slice].m_buffer
+                + get_buffer_offset(slice, offset_type::beam_real, beams, laser, b, rcomp);
+            for (std::size_t i = 0; i < num_particles; ++i) {
+                uint_type bits;
+                std::memcpy(&bits, ptr + i * sizeof(uint_type), sizeof(uint_type));
+                // round to nearest, a carry into the exponent is still correctly rounded
+                bits = (bits + half) & mask;
+                std::memcpy(ptr + i * sizeof(uint_type), &bits, sizeof(uint_type));
+            }
+        }
+    }
+}
+
+void MultiBuffer::compress_buffer (int slice) {
+    HIPACE_PROFILE("MultiBuffer::compress_buffer()");
+    // The buffer is viewed as an array of 64 bit words. Each word is XORed with its predecessor
+    // so that similar neighboring values produce leading zero bytes, then the bytes are
+    // shuffled such that byte k of all words is stored contiguously. The result is encoded
+    // with a run-length encoding of zero bytes:
+    // control byte c < 128: c+1 literal bytes follow, control byte c >= 128: c-127 zero bytes.
+    constexpr std::size_t word_size = sizeof(std::uint64_t);
+    const std::size_t buffer_size = m_datanodes[slice].m_buffer_size;
+    const std::size_t num_bytes = buffer_size * sizeof(storage_type);
+    const std::size_t num_words = num_bytes / word_size;
+    const char* buffer = m_datanodes[slice].m_buffer;
+
+    m_codec_shuffled.resize(num_bytes);
+    std::uint64_t prev = 0;
+    for (std::size_t i = 0; i < num_words; ++i) {
+        std::uint64_t word;
+        std::memcpy(&word, buffer + i * word_size, word_size);
+        const std::uint64_t delta = word ^ prev;
+        prev = word;
+        for (std::size_t k = 0; k < word_size; ++k) {
+            m_codec_shuffled[k * num_words + i] = static_cast<char>((delta >> (8 * k)) & 0xff);
+        }
+    }
+
+    m_codec_encoded.resize(num_bytes + num_bytes / 128 + 1);
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(m_codec_shuffled.data());
+    unsigned char* out = reinterpret_cast<unsigned char*>(m_codec_encoded.data());
+    std::size_t in_pos = 0;
+    std::size_t out_pos = 0;
+    while (in_pos < num_bytes) {
+        std::size_t run = 0;
+        while (in_pos + run < num_bytes && run < 128 && in[in_pos + run] == 0) ++run;
+        if (run >= 2 || (run == 1 && in_pos + 1 == num_bytes)) {
+            out[out_pos++] = static_cast<unsigned char>(127 + run);
+            in_pos += run;
+        } else {
+            // collect literals until the next pair of zero bytes
+            std::size_t lit = 0;
+            while (in_pos + lit < num_bytes && lit < 128 &&
+                   !(in[in_pos + lit] == 0 && in_pos + lit + 1 < num_bytes
+                     && in[in_pos + lit + 1] == 0)) {
+                ++lit;
+            }
+            out[out_pos++] = static_cast<unsigned char>(lit - 1);
+            std::memcpy(out + out_pos, in + in_pos, lit);
+            out_pos += lit;
+            in_pos += lit;
+        }
+    }
+
+    const std::size_t compressed_size = (out_pos + sizeof(storage_type) - 1) / sizeof(storage_type);
+    if (compressed_size >= buffer_size) {
+        // incompressible data is sent as is
+        return;
+    }
+
+    free_buffer(slice);
+    m_datanodes[slice].m_buffer_size = compressed_size;
+    allocate_buffer(slice);
+    std::memcpy(m_datanodes[slice].m_buffer, m_codec_encoded.data(), out_pos);
+    std::memset(m_datanodes[slice].m_buffer + out_pos, 0,
+                compressed_size * sizeof(storage_type) - out_pos);
+    get_metadata_location(slice)[0] = compressed_size;
+    get_metadata_location(slice)[m_nbeams + 1] = buffer_size;
+}
+
+void MultiBuffer::decompress_buffer (int slice) {
+    const std::size_t buffer_size = get_metadata_location(slice)[m_nbeams + 1];
+    if (buffer_size == 0) {
+        // buffer was sent uncompressed
+        return;
+    }
+    HIPACE_PROFILE("MultiBuffer::decompress_buffer()");
+    constexpr std::size_t word_size = sizeof(std::uint64_t);
+    const std::size_t num_bytes = buffer_size * sizeof(storage_type);
+    const std::size_t num_words = num_bytes / word_size;
+    const std::size_t num_bytes_compressed = m_datanodes[slice].m_buffer_size * sizeof(storage_type);
+
+    m_codec_shuffled.resize(num_bytes);
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(m_datanodes[slice].m_buffer);
+    unsigned char* out = reinterpret_cast<unsigned char*>(m_codec_shuffled.data());
+    std::size_t in_pos = 0;
+    std::size_t out_pos = 0;
+    while (out_pos < num_bytes) {
+        AMREX_ALWAYS_ASSERT(in_pos < num_bytes_compressed);
+        const std::size_t control = in[in_pos++];
+        if (control >= 128) {
+            const std::size_t run = control - 127;
+            std::memset(out + out_pos, 0, run);
+            out_pos += run;
+        } else {
+            const std::size_t lit = control + 1;
+            std::memcpy(out + out_pos, in + in_pos, lit);
+            out_pos += lit;
+            in_pos += lit;
+        }
+    }
+    AMREX_ALWAYS_ASSERT(out_pos == num_bytes);
+
+    free_buffer(slice);
+    m_datanodes[slice].m_buffer_size = buffer_size;
+    allocate_buffer(slice);
+    char* buffer = m_datanodes[slice].m_buffer;
+    std::uint64_t prev = 0;
+    for (std::size_t i = 0; i < num_words; ++i) {
+        std::uint64_t delta = 0;
+        for (std::size_t k = 0; k < word_size; ++k) {
+            delta |= std::uint64_t(static_cast<unsigned char>(m_codec_shuffled[k * num_words + i]))
+                << (8 * k);
+        }
+        prev ^= delta;
+        std::memcpy(buffer + i * word_size, &prev, word_size);
+    }
+}
+
 void MultiBuffer::pack_data (int slice, MultiBeam& beams, MultiLaser& laser, int beam_slice) {
     for (int b = 0; b < m_nbeams; ++b) {
         auto& beam = beams.getBeam(b);
@@ -823,7 +1015,7 @@ void MultiBuffer::pack_data (int slice, MultiBeam& beams, MultiLaser& laser, int
                 memcpy_to_buffer(slice, get_buffer_offset(slice, offset_type::beam_real,
                                                           beams, laser, b, rcomp),
                                  soa.GetRealData(rcomp).dataPtr(),
-                                 num_particles * sizeof(amrex::Real));
+                                 num_particles * sizeof(amrex::ParticleReal));
             }
         }
 
@@ -884,7 +1076,7 @@ void MultiBuffer::unpack_data (int slice, MultiBeam& beams, MultiLaser& laser, i
                 memcpy_from_buffer(slice, get_buffer_offset(slice, offset_type::beam_real,
                                                             beams, laser, b, rcomp),
                                    soa.GetRealData(rcomp).dataPtr(),
-                                   num_particles * sizeof(amrex::Real));
+                                   num_particles * sizeof(amrex::ParticleReal));
             } else {
                 // initialize per-slice-only real components to zero
                 amrex::Real* data_ptr = soa.GetRealData(rcomp).dataPtr();
@@ -0,0 +1,127 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "ScratchArena.H"
+
+#include <AMReX.H>
+#include <AMReX_Gpu.H>
+
+#include <algorithm>
+#include <memory>
+
+namespace
+{
+    /** alignment of every allocation, enough for coalesced GPU access */
+    constexpr std::size_t scratch_align = 256;
+
+    std::size_t AlignUp (std::size_t sz) noexcept
+    {
+        return (sz + scratch_align - 1) / scratch_align * scratch_align;
+    }
+
+    std::unique_ptr<ScratchArena> the_scratch_arena;
+}
+
+ScratchArena::ScratchArena ()
+{
+    // same kind of memory as The_Arena, from which all memory is taken
+    arena_info = amrex::The_Arena()->arenaInfo();
+}
+
+ScratchArena::~ScratchArena ()
+{
+    amrex::Gpu::streamSynchronize();
+    for (void* pt : m_overflow) {
+        amrex::The_Arena()->free(pt);
+    }
+    if (m_block) {
+        amrex::The_Arena()->free(m_block);
+    }
+}
+
+void*
+ScratchArena::alloc (std::size_t sz)
+{
+    sz = AlignUp(std::max(sz, std::size_t(1)));
+    void* pt = nullptr;
+    if (m_block && m_block_used + sz <= m_capacity) {
+        pt = m_block + m_block_used;
+        m_block_used += sz;
+    } else {
+        pt = amrex::The_Arena()->alloc(sz);
+        m_overflow.push_back(pt);
+    }
+    m_used += sz;
+    m_slice_usage = std::max(m_slice_usage, m_used);
+    return pt;
+}
+
+void
+ScratchArena::free (void* /*pt*/)
+{}
+
+void
+ScratchArena::Reset ()
+{
+    // the memory may still be in use by kernels of this slice
+    amrex::Gpu::streamSynchronize();
+
+    m_last_slice_usage = m_slice_usage;
+    m_peak_usage = std::max(m_peak_usage, m_slice_usage);
+
+    for (void* pt : m_overflow) {
+        amrex::The_Arena()->free(pt);
+    }
+    m_overflow.clear();
+
+    if (m_peak_usage > m_capacity) {
+        if (m_block) {
+            amrex::The_Arena()->free(m_block);
+        }
+        m_capacity = m_peak_usage;
+        m_block = static_cast<char*>(amrex::The_Arena()->alloc(m_capacity));
+    }
+    m_block_used = 0;
+    m_used = 0;
+    m_slice_usage = 0;
+}
+
+void
+ScratchArena::Rewind (const Mark& mark)
+{
+    AMREX_ASSERT(mark.m_block_used <= m_block_used && mark.m_used <= m_used &&
+                 mark.m_num_overflow <= m_overflow.size());
+    if (m_overflow.size() > mark.m_num_overflow) {
+        // unlike the block, memory returned to The_Arena may be used by another stream
+        amrex::Gpu::streamSynchronize();
+        for (std::size_t i = mark.m_num_overflow; i < m_overflow.size(); ++i) {
+            amrex::The_Arena()->free(m_overflow[i]);
+        }
+        m_overflow.resize(mark.m_num_overflow);
+    }
+    m_block_used = mark.m_block_used;
+    m_used = mark.m_used;
+}
+
+ScratchScope::ScratchScope ()
+    : m_mark(The_Scratch_Arena()->GetMark())
+{}
+
+ScratchScope::~ScratchScope ()
+{
+    The_Scratch_Arena()->Rewind(m_mark);
+}
+
+ScratchArena*
+The_Scratch_Arena ()
+{
+    if (!the_scratch_arena) {
+        the_scratch_arena = std::make_unique<ScratchArena>();
+        // The_Arena has to outlive the scratch arena
+        amrex::ExecOnFinalize([] () { the_scratch_arena.reset(); });
+    }
+    return the_scratch_arena.get();
+}
@@ -25,6 +25,10 @@ HIPACE_TEST_DIR=${HIPACE_SOURCE_DIR}/tests
 FILE_NAME=`basename "$0"`
 TEST_NAME="${FILE_NAME%.*}"
 
+rm -rf $TEST_NAME
+rm -rf ${TEST_NAME}_adaptive_subcycling ${TEST_NAME}_adaptive_subcycling.log
+rm -rf ${TEST_NAME}_table
+
 # Relative tolerance for checksum tests depends on the platform
 RTOL=1e-12 && [[ "$HIPACE_EXECUTABLE" == *"hipace"*".CUDA."* ]] && RTOL=2e-6
 
@@ -52,3 +56,57 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --rtol $RTOL \
     --file_name $TEST_NAME \
     --test-name $TEST_NAME
+
+echo "Start testing adaptive sub-cycling"
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        amr.n_cell = 32 32 10 \
+        max_step = 20 \
+        geometry.prob_lo = -2. -2. -2. \
+        geometry.prob_hi =  2.  2.  2. \
+        hipace.dt = 3. \
+        diagnostic.output_period = 20 \
+        beam.density = 1.e-8 \
+        beam.radius = 1. \
+        beam.ppc = 4 4 1 \
+        beam.adaptive_subcycling = 1 \
+        beam.n_subcycles_max = 8 \
+        beam.subcycling_max_phase = 0.02 \
+        'beams.external_E(x,y,z,t) = .5*x .5*y 0.' \
+        hipace.verbose = 2 \
+        hipace.file_prefix = ${TEST_NAME}_adaptive_subcycling \
+        | tee ${TEST_NAME}_adaptive_subcycling.log
+
+# Compare the result with theory
+$HIPACE_EXAMPLE_DIR/analysis_beam_push.py --output-dir=${TEST_NAME}_adaptive_subcycling
+
+# The focusing field needs about 4 sub-cycles per particle, check that fewer than
+# n_subcycles_max = 8 were used on average in every time step
+sed -n 's/.*avg\. \([0-9.eE+-]*\) per particle.*/\1/p' ${TEST_NAME}_adaptive_subcycling.log \
+    | awk 'BEGIN {n = 0} {if ($1 > 0) n++; if ($1 >= 8) {print "avg. sub-cycles " $1; exit 1}}
+           END {if (n == 0) {print "no sub-cycling statistics found"; exit 1}}'
+
+echo "Start testing tabulated external fields"
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        amr.n_cell = 32 32 10 \
+        max_step = 20 \
+        geometry.prob_lo = -2. -2. -2. \
+        geometry.prob_hi =  2.  2.  2. \
+        hipace.dt = 3. \
+        diagnostic.output_period = 20 \
+        beam.density = 1.e-8 \
+        beam.radius = 1. \
+        beam.ppc = 4 4 1 \
+        'beams.external_E(x,y,z,t) = .5*x .5*y 0.' \
+        beams.external_fields_table_size = 8 8 8 \
+        hipace.file_prefix = ${TEST_NAME}_table
+
+# the external fields are linear, so the table reproduces them exactly
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol $RTOL \
+    --file_name ${TEST_NAME}_table \
+    --test-name $TEST_NAME
@@ -52,3 +52,66 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --rtol $RTOL \
     --file_name $TEST_NAME \
     --test-name $TEST_NAME
+
+echo "Start testing asynchronous beam output with particle loss"
+
+rm -rf ${TEST_NAME}_sync
+rm -rf ${TEST_NAME}_async
+rm -rf ${TEST_NAME}_async_chunked
+
+# The beam drifts transversely into the absorbing boundary and loses particles every step
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        amr.n_cell = 64 64 16 \
+        boundary.particle = Absorbing \
+        geometry.prob_lo     = -4.   -4.   -2.  \
+        geometry.prob_hi     =  4.    4.    2.  \
+        beam.radius = 0.5 \
+        beam.position_mean = 3.2 0. 0. \
+        beam.u_mean = 300. 0. 1.e3 \
+        hipace.dt = 1. \
+        max_step = 3 \
+        diagnostic.field_data = none \
+        hipace.file_prefix=${TEST_NAME}_sync
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        amr.n_cell = 64 64 16 \
+        boundary.particle = Absorbing \
+        geometry.prob_lo     = -4.   -4.   -2.  \
+        geometry.prob_hi     =  4.    4.    2.  \
+        beam.radius = 0.5 \
+        beam.position_mean = 3.2 0. 0. \
+        beam.u_mean = 300. 0. 1.e3 \
+        hipace.dt = 1. \
+        max_step = 3 \
+        diagnostic.field_data = none \
+        hipace.openpmd_async_write = 1 \
+        hipace.file_prefix=${TEST_NAME}_async
+
+# The asynchronous output must contain the same particles as the synchronous output
+$HIPACE_EXAMPLE_DIR/analysis_async_output.py \
+    --reference ${TEST_NAME}_sync \
+    --async ${TEST_NAME}_async
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        amr.n_cell = 64 64 16 \
+        boundary.particle = Absorbing \
+        geometry.prob_lo     = -4.   -4.   -2.  \
+        geometry.prob_hi     =  4.    4.    2.  \
+        beam.radius = 0.5 \
+        beam.position_mean = 3.2 0. 0. \
+        beam.u_mean = 300. 0. 1.e3 \
+        hipace.dt = 1. \
+        max_step = 3 \
+        diagnostic.field_data = none \
+        hipace.openpmd_async_write = 1 \
+        hipace.openpmd_beam_chunk_size = 256 \
+        hipace.file_prefix=${TEST_NAME}_async_chunked
+
+# Lost particles are zero padded at the end of the chunked output
+$HIPACE_EXAMPLE_DIR/analysis_async_output.py \
+    --reference ${TEST_NAME}_sync \
+    --async ${TEST_NAME}_async_chunked \
+    --chunked
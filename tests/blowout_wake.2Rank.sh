@@ -32,6 +32,8 @@ rm -rf si_data
 rm -rf si_data_fixed_weight
 rm -rf normalized_data
 rm -rf normalized_data_cd2
+rm -rf normalized_data_compression
+rm -rf normalized_data_compression_lossy
 # Run the simulation
 mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_SI \
         hipace.tile_size = 8 \
@@ -79,3 +81,36 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --file_name normalized_data_cd2/ \
     --test-name blowout_wake.2Rank \
     --skip "{'beam': 'id'}"
+
+echo "Start testing compressed beam communication"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=normalized_data_compression/ \
+        comms_buffer.on_gpu = 0 \
+        comms_buffer.compression = 1 \
+        max_step=1
+
+# Lossless compression must reproduce the benchmark
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol $RTOL \
+    --file_name normalized_data_compression/ \
+    --test-name blowout_wake.2Rank \
+    --skip "{'beam': 'id'}"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=normalized_data_compression_lossy/ \
+        comms_buffer.on_gpu = 0 \
+        comms_buffer.compression = 1 \
+        comms_buffer.compression_momentum_bits = 20 \
+        max_step=1
+
+# Momenta rounded to 20 mantissa bits have a relative error below 1e-6
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol 1e-5 \
+    --file_name normalized_data_compression_lossy/ \
+    --test-name blowout_wake.2Rank \
+    --skip "{'beam': 'id'}"
@@ -28,6 +28,11 @@ TEST_NAME="${FILE_NAME%.*}"
 
 rm -rf $TEST_NAME
 rm -rf ${TEST_NAME}_cd2
+rm -rf ${TEST_NAME}_cd3
+rm -rf ${TEST_NAME}_fused
+rm -rf ${TEST_NAME}_guess2
+rm -rf ${TEST_NAME}_bicgstab
+rm -rf ${TEST_NAME}_mixed_precision
 # Run the simulation
 mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
         hipace.tile_size = 8 \
@@ -54,3 +59,78 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --file_name ${TEST_NAME}_cd2 \
     --test-name $TEST_NAME \
     --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_cd3 \
+        plasmas.reorder_period = 4 \
+        plasmas.incremental_reorder = 1 \
+        max_step=1
+
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --file_name ${TEST_NAME}_cd3 \
+    --test-name $TEST_NAME \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+echo "Start testing fused plasma push and deposition"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_fused \
+        hipace.fuse_plasma_push_deposit = 1 \
+        max_step=1
+
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --file_name ${TEST_NAME}_fused \
+    --test-name $TEST_NAME \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+echo "Start testing quadratic initial guess of the multigrid solver"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_guess2 \
+        hipace.MG_initial_guess_order = 2 \
+        max_step=1
+
+# The solution only changes within the multigrid tolerance
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol 1e-3 \
+    --file_name ${TEST_NAME}_guess2 \
+    --test-name $TEST_NAME \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+echo "Start testing BiCGStab multigrid solver"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_bicgstab \
+        hipace.MG_use_bicgstab = 1 \
+        max_step=1
+
+# The solution only changes within the multigrid tolerance
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol 1e-3 \
+    --file_name ${TEST_NAME}_bicgstab \
+    --test-name $TEST_NAME \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+echo "Start testing mixed-precision multigrid solver"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_mixed_precision \
+        hipace.MG_use_mixed_precision = 1 \
+        max_step=1
+
+# Iterative refinement keeps the error within the multigrid tolerance
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol 1e-3 \
+    --file_name ${TEST_NAME}_mixed_precision \
+    --test-name $TEST_NAME \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
@@ -44,3 +44,23 @@ $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
 # Compare the beams
 $HIPACE_EXAMPLE_DIR/analysis_from_file.py --beam-py beam_%T.h5 \
                                           --beam-out1 ${TEST_NAME}/openpmd_%T.h5
+
+echo "Start testing reading the beam in chunks"
+
+# The file has 1000000 particles, the last chunk is only partially filled
+$HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_chunked \
+        amr.n_cell = 16 16 32 \
+        hipace.dt = 0 \
+        geometry.prob_lo = -8. -8. -8. \
+        geometry.prob_hi =  8.  8.  8. \
+        beam.injection_type = from_file \
+        beam.input_file = beam_%T.h5 \
+        beam.iteration = 0 \
+        beam.openPMD_species_name = Electrons \
+        beam.file_chunk_size = 300000 \
+        beam.plasma_density = 2.8239587008591567e23 # to convert beam to normalized units
+
+$HIPACE_EXAMPLE_DIR/analysis_from_file.py --beam-py beam_%T.h5 \
+                                          --beam-out1 ${TEST_NAME}_chunked/openpmd_%T.h5
@@ -40,6 +40,20 @@ mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_ion_motion_SI \
 # Compare the result with theory
 $HIPACE_EXAMPLE_DIR/analysis_equal.py --first=$TEST_NAME/pc  --second=$TEST_NAME/e
 
+echo "Start testing predictor-corrector loop with Anderson mixing"
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_ion_motion_SI \
+        hipace.bxby_solver = predictor-corrector \
+        hipace.predcorr_anderson_depth = 3 \
+        hipace.predcorr_B_mixing_factor = 0.0635 \
+        hipace.predcorr_max_iterations = 7 \
+        hipace.predcorr_B_error_tolerance = 0.0001 \
+        hipace.file_prefix=$TEST_NAME/pc_anderson
+
+# Anderson mixing must converge to the same fields as the other solvers
+$HIPACE_EXAMPLE_DIR/analysis_equal.py --first=$TEST_NAME/pc  --second=$TEST_NAME/pc_anderson
+$HIPACE_EXAMPLE_DIR/analysis_equal.py --first=$TEST_NAME/pc_anderson  --second=$TEST_NAME/e
+
 # Compare the results with checksum benchmark
 $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --evaluate \
@@ -26,6 +26,7 @@ FILE_NAME=`basename "$0"`
 TEST_NAME="${FILE_NAME%.*}"
 
 rm -rf $TEST_NAME
+rm -rf ${TEST_NAME}_table ${TEST_NAME}_table.log
 
 # Run the simulation
 mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_ionization_SI \
@@ -41,3 +42,24 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --file_name $TEST_NAME \
     --test-name $TEST_NAME \
     --skip "{'beam': 'id'}"
+
+echo "Start testing the ADK ionization table"
+
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_ionization_SI \
+        hipace.tile_size = 8 \
+        hipace.dt = 1e-12 \
+        diagnostic.output_period = 2 \
+        hipace.file_prefix=${TEST_NAME}_table \
+        hipace.verbose = 1 \
+        plasmas.ionization_table_size = 1024 \
+        max_step=2 \
+        | tee ${TEST_NAME}_table.log
+
+# The interpolated ADK rate is compared with the ADK formula between all table points
+# at initialization, check that the table is accurate and used
+if grep -q "WARNING: relative interpolation error" ${TEST_NAME}_table.log; then
+    exit 1
+fi
+sed -n 's/.*max\. relative error of the rate \([0-9.eE+-]*\).*/\1/p' ${TEST_NAME}_table.log \
+    | awk 'BEGIN {n = 0} {n++; if (!($1 < 1e-4)) {print "ADK table error " $1; exit 1}}
+           END {if (n == 0) {print "no ADK table found"; exit 1}}'
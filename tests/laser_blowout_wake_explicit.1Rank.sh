@@ -20,6 +20,9 @@ HIPACE_TEST_DIR=${HIPACE_SOURCE_DIR}/tests
 FILE_NAME=`basename "$0"`
 TEST_NAME="${FILE_NAME%.*}"
 
+rm -rf $TEST_NAME
+rm -rf ${TEST_NAME}_fused
+
 # Run the simulation
 mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
         hipace.tile_size = 8 \
@@ -34,7 +37,7 @@ mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
         laser.position_mean = 0. 0. 0 \
         laser.w0 = 4 \
         laser.L0 = 2 \
-        amr.n_cell = 128 128 100 \
+        amr.n_cell = 128 128 100
 
 # Compare the results with checksum benchmark
 $HIPACE_TEST_DIR/checksum/checksumAPI.py \
@@ -43,3 +46,28 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --test-name $TEST_NAME \
     --skip-particles \
     --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
+
+echo "Start testing fused plasma push and deposition"
+
+mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.file_prefix=${TEST_NAME}_fused \
+        hipace.fuse_plasma_push_deposit = 1 \
+        max_step = 0 \
+        beams.names = no_beam \
+        geometry.prob_lo     = -20.   -20.   -7.5  \
+        geometry.prob_hi     =  20.    20.    6  \
+        lasers.names = laser \
+        lasers.lambda0 = .8e-6 \
+        laser.a0 = 4.5 \
+        laser.position_mean = 0. 0. 0 \
+        laser.w0 = 4 \
+        laser.L0 = 2 \
+        amr.n_cell = 128 128 100
+
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --file_name ${TEST_NAME}_fused \
+    --test-name $TEST_NAME \
+    --skip-particles \
+    --skip "{'lev=0' : ['Sy', 'Sx', 'chi']}"
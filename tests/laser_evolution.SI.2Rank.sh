@@ -37,6 +37,16 @@ $HIPACE_EXAMPLE_DIR/analysis_laser_vacuum.py --output-dir=$TEST_NAME
 
 rm -rf $TEST_NAME
 
+# Run the simulation with multigrid Poisson solver using BiCGStab
+mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_SI \
+        lasers.solver_type = multigrid \
+        lasers.MG_use_bicgstab = 1 \
+        hipace.file_prefix = $TEST_NAME
+# Compare the result with theory
+$HIPACE_EXAMPLE_DIR/analysis_laser_vacuum.py --output-dir=$TEST_NAME
+
+rm -rf $TEST_NAME
+
 # Run the simulation with FFT Poisson solver
 mpiexec -n 2 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_SI \
         lasers.solver_type = fft \
@@ -25,6 +25,9 @@ HIPACE_TEST_DIR=${HIPACE_SOURCE_DIR}/tests
 FILE_NAME=`basename "$0"`
 TEST_NAME="${FILE_NAME%.*}"
 
+rm -rf $TEST_NAME
+rm -rf ${TEST_NAME}_private_tiles
+
 # Relative tolerance for checksum tests depends on the platform
 RTOL=1e-12 && [[ "$HIPACE_EXECUTABLE" == *"hipace"*".CUDA."* ]] && RTOL=1e-7
 
@@ -43,3 +46,17 @@ $HIPACE_TEST_DIR/checksum/checksumAPI.py \
     --rtol $RTOL \
     --file_name $TEST_NAME \
     --test-name $TEST_NAME
+
+echo "Start testing deposition into thread-private tile buffers"
+
+OMP_NUM_THREADS=2 mpiexec -n 1 $HIPACE_EXECUTABLE $HIPACE_EXAMPLE_DIR/inputs_normalized \
+        hipace.tile_size = 8 \
+        hipace.do_private_tile_depos = 1 \
+        diagnostic.field_data = all rho \
+        hipace.file_prefix=${TEST_NAME}_private_tiles
+
+$HIPACE_TEST_DIR/checksum/checksumAPI.py \
+    --evaluate \
+    --rtol $RTOL \
+    --file_name ${TEST_NAME}_private_tiles \
+    --test-name $TEST_NAME
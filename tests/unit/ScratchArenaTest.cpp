@@ -0,0 +1,104 @@
+/* Copyright 2024
+ *
+ * This file is part of HiPACE++.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "utils/ScratchArena.H"
+
+#include <AMReX.H>
+#include <AMReX_Gpu.H>
+#include <AMReX_Print.H>
+
+#include <string>
+
+/** \brief Tests the bump-pointer arena for temporary buffers: allocations that do not fit into
+ * the block, growing the block in Reset, rewinding with ScratchScope and the usage counters.
+ * All sizes are multiples of the 256 byte alignment of the arena.
+ */
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    int num_failed = 0;
+    {
+        auto check = [&] (bool ok, const std::string& what) {
+            if (!ok) {
+                ++num_failed;
+                amrex::Print() << "FAILED: " << what << "\n";
+            }
+        };
+
+        ScratchArena* arena = The_Scratch_Arena();
+        check(arena->Capacity() == 0 && arena->Usage() == 0, "empty arena");
+
+        // first slice: there is no block yet, so all allocations overflow to The_Arena
+        arena->alloc(1000);
+        arena->alloc(100);
+        check(arena->NumOverflow() == 2, "overflow without block");
+        check(arena->Usage() == 1280, "usage includes the alignment");
+        arena->Reset();
+        check(arena->Usage() == 0 && arena->NumOverflow() == 0, "Reset releases everything");
+        check(arena->LastSliceUsage() == 1280 && arena->PeakUsage() == 1280,
+              "usage of the first slice");
+        check(arena->Capacity() == 1280, "Reset grows the block to the peak usage");
+
+        // second slice: memory of a closed scope is reused, the usage stays below the block
+        void* first = nullptr;
+        void* second = nullptr;
+        {
+            ScratchScope scope;
+            first = arena->alloc(1024);
+            // the memory is usable on the device
+            int* const p_data = static_cast<int*>(first);
+            amrex::ParallelFor(256, [=] AMREX_GPU_DEVICE (int i) noexcept { p_data[i] = i + 7; });
+            amrex::Gpu::HostVector<int> host(256);
+            amrex::Gpu::copy(amrex::Gpu::deviceToHost, p_data, p_data + 256, host.begin());
+            bool values_ok = true;
+            for (int i = 0; i < 256; ++i) values_ok = values_ok && host[i] == i + 7;
+            check(values_ok, "content of the scratch memory");
+        }
+        check(arena->Usage() == 0, "closed scope releases its allocations");
+        {
+            ScratchScope scope;
+            second = arena->alloc(1024);
+        }
+        check(first == second, "closed scope memory is reused");
+        check(arena->NumOverflow() == 0, "no overflow when the block is large enough");
+        arena->Reset();
+        check(arena->LastSliceUsage() == 1024, "usage of a slice is the largest live usage");
+        check(arena->PeakUsage() == 1280 && arena->Capacity() == 1280,
+              "block does not grow for smaller slices");
+
+        // third slice: a nested scope overflows and releases its overflow allocation
+        {
+            ScratchScope outer;
+            arena->alloc(1024);
+            {
+                ScratchScope inner;
+                arena->alloc(1024);
+                check(arena->NumOverflow() == 1, "overflow when the block is full");
+                check(arena->Usage() == 2048, "usage with overflow");
+            }
+            check(arena->NumOverflow() == 0, "inner scope frees its overflow allocation");
+            check(arena->Usage() == 1024, "inner scope rewinds to the outer allocation");
+        }
+        arena->Reset();
+        check(arena->LastSliceUsage() == 2048 && arena->PeakUsage() == 2048,
+              "peak usage includes overflow allocations");
+        check(arena->Capacity() == 2048, "Reset grows the block after an overflow");
+
+        // fourth slice: the grown block fits the same allocations
+        {
+            ScratchScope scope;
+            arena->alloc(1024);
+            arena->alloc(1024);
+            check(arena->NumOverflow() == 0, "no overflow after the block was grown");
+        }
+        arena->Reset();
+        check(arena->PeakUsage() == 2048, "peak usage is kept");
+
+        amrex::Print() << "ScratchArena test: " << num_failed << " checks failed\n";
+    }
+    amrex::Finalize();
+    return num_failed == 0 ? 0 : 1;
+}
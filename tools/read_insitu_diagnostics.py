@@ -40,6 +40,35 @@ def read_file(filenames):
         np.frombuffer(**get_buffer(file)) for file in glob.iglob(filenames)
     ], usemask=False, asrecarray=False, autoconvert=True), order="time")
 
+def read_step(filename, step):
+    """
+    Extract the insitu diagnostics of a single time step into a NumPy structured array
+    without reading the whole file, using the index file written next to it
+
+    Parameters
+    ----------
+
+    filename: string
+        Path and name of one file containing insitu diagnostics eg. "diags/insitu/reduced_beam.0000.txt"
+    step: int
+        Time step to read
+
+    Returns
+    -------
+
+    NumPy structured array with one entry, same format as read_file()
+    """
+    index = np.atleast_2d(np.loadtxt(filename[:-len(".txt")] + ".index", dtype=np.int64))
+    offsets = index[index[:,0] == step, 1]
+    if len(offsets) == 0:
+        raise ValueError("Step " + str(step) + " not found in " + filename)
+    with open(filename, "rb") as f:
+        # the header ends where the first record starts
+        header = f.read(index[0,1]).decode(errors="replace")
+        dtype = np.dtype(json.JSONDecoder().raw_decode(header)[0])
+        f.seek(offsets[-1])
+        return np.frombuffer(f.read(dtype.itemsize), dtype=dtype)
+
 def emittance_x(all_data):
     """
     Per-slice emittance: emittance_x(all_data)
@@ -202,6 +231,24 @@ def per_slice_charge(all_data):
 def total_charge(all_data):
     return all_data["charge"] * all_data["total"]["sum(w)"] * all_data["normalized_density_factor"]
 
+def per_slice_current(all_data):
+    """
+    Per-slice current, in A in SI units and normalized to e * n0 * c * kp^-2 in normalized units
+    """
+    dz = (all_data["z_hi"] - all_data["z_lo"]) / all_data["n_slices"]
+    c = np.where(all_data["is_normalized_units"], 1., constants.c)
+    return per_slice_charge(all_data) * np.atleast_2d(c / dz).T
+
+def histogram(all_data, name):
+    """
+    Sum of the weights of an in-situ histogram, reshaped to (timesteps, bins of axis 0, bins of axis 1)
+    for 2D histograms. The bin edges of each axis are given by
+    np.linspace(all_data["histograms"][name]["min"][0], all_data["histograms"][name]["max"][0], bins+1)
+    """
+    hist = all_data["histograms"][name]
+    bins = np.atleast_1d(hist["bins"][0])
+    return np.reshape(hist["sum(w)"], (-1, *bins))
+
 def z_axis(all_data):
     return (np.linspace(all_data["z_lo"][0], all_data["z_hi"][0], all_data["n_slices"][0]+1)[1:] \
         + np.linspace(all_data["z_lo"][0], all_data["z_hi"][0], all_data["n_slices"][0]+1)[:-1])*0.5